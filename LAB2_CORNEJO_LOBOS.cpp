@@ -11,6 +11,36 @@
 #include <random>         // Para generación de números aleatorios
 #include <sys/types.h>    // Para tipos de datos del sistema (pid_t)
 #include <errno.h>        // Para manejo de errores (perror)
+#include <climits>        // Para INT_MAX
+#include <sys/eventfd.h>  // Para eventfd (aviso de término de los equipos)
+#include <sys/epoll.h>    // Para epoll (espera bloqueante del coordinador)
+#include <sys/syscall.h>  // Para syscall(SYS_futex, ...)
+#include <linux/futex.h>  // Para FUTEX_WAIT / FUTEX_WAKE (barrera de inicio)
+#include <algorithm>      // Para max
+#include <thread>         // Para std::thread (modo batch Monte Carlo)
+#include <atomic>         // Para el contador atómico de corridas del modo batch
+#include <cmath>          // Para sqrt (intervalos de confianza)
+#include <cstdint>        // Para int32_t/uint64_t de los lotes SoA y el generador
+#include <fstream>        // Para leer el archivo de configuración (--config)
+#include <iomanip>        // Para setw (tabla de --scaling)
+#include <mutex>          // Para serializar los bloques de traza y las colas del pool
+#include <condition_variable> // Para dormir a los trabajadores del pool sin tareas
+#include <deque>          // Para las colas de tareas del pool con robo de trabajo
+#include <functional>     // Para std::function (tareas del pool)
+#include <memory>         // Para unique_ptr (backends de ejecución)
+#include <coroutine>      // Para las corrutinas del motor de eventos discretos (--des)
+#include <map>            // Para los candidatos ya evaluados del barrido (--sweep)
+#include <sstream>        // Para separar la especificación de --sweep
+#include <fcntl.h>        // Para open (archivo de traza)
+#include <sys/stat.h>     // Para fstat (tamaño de la traza a mapear)
+#include <sys/mman.h>     // Para mmap (lectura de la traza en --replay/--query)
+#include <sched.h>        // Para sched_setaffinity y sched_setscheduler (--cpus, --sched)
+#include <sys/resource.h> // Para setpriority (--sched alta)
+#include <linux/mempolicy.h> // Para MPOL_PREFERRED (mbind del segmento, --numa)
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>    // Para intrínsecos SSE4.1/AVX2 del motor en lockstep
+#define KERNELS_X86 1
+#endif
 
 using namespace std;
 
@@ -19,31 +49,258 @@ using namespace std;
 #define Fo(i, k, n) for (i=k; i<n; i++)      // Bucle desde k hasta n-1
 
 //Estructuras de Datos
-//Almacena la cantidad de recursos recolectados por todos los equipos (unidades)
+
+//Tipos de recurso que el grupo necesita cada día (índices de Recursos::cantidad)
+const int NUM_RECURSOS = 4;
+enum TipoRecursoId {
+    RECURSO_AGUA = 0,
+    RECURSO_ALIMENTOS = 1,
+    RECURSO_CONSTRUCCION = 2,
+    RECURSO_SENALES = 3
+};
+
+//Almacena la cantidad de recursos recolectados por todos los equipos (unidades), por tipo de recurso
 struct Recursos {
-    int agua;
-    int alimentos;
-    int construccion;
-    int senales;
+    int cantidad[NUM_RECURSOS];
 };
 
 
 //Información reportada por cada equipo de recolección
-struct ReporteEquipo {
-    int id_equipo;             //Identificador del equipo (0-3)
+//alignas(64): cada reporte ocupa su propia línea de caché, así cientos de equipos
+//escribiendo a la vez no se invalidan la caché entre sí (false sharing)
+struct alignas(64) ReporteEquipo {
+    int id_equipo;             //Identificador del equipo (0 a num_equipos-1)
     int recursos_recolectados; //Cantidad de unidades obtenidas por el equipo
-    int estado_equipo;         //Estado actual del equipo (0: trabajando, 1: completado, -1: error)
+    int estado_equipo;         //Estado actual del equipo (0: trabajando, 1: completado, 2: fallido, -1: error)
     pid_t pid_equipo;          //PID del proceso que representa al equipo
+    long long t_lanzamiento_ns; //Instante (CLOCK_MONOTONIC) en que el coordinador hizo fork o liberó la barrera
+    long long t_entrada_ns;    //Instante en que el proceso del equipo empezó a ejecutar (tras fork o futex)
+    long long t_inicio_ns;     //Instante (CLOCK_MONOTONIC) en que el equipo comenzó sus fases del día
+    long long t_recoleccion_ns; //Instante en que terminó la exploración y empezó la recolección
+    long long t_finalizacion_ns; //Instante en que empezó la finalización
+    long long t_fin_ns;        //Instante (CLOCK_MONOTONIC) en que el equipo terminó y reportó
+    int seg_exploracion;       //Duración simulada de la fase de exploración (segundos de reloj virtual)
+    int seg_recoleccion;       //Duración simulada de la fase de recolección
+    int seg_finalizacion;      //Duración simulada de la fase de finalización
+};
+
+//Fases que un equipo anuncia durante el día (antes se escribían directo a cout desde el hijo)
+enum FaseEquipo {
+    FASE_EXPLORACION = 0,
+    FASE_RECOLECCION = 1,
+    FASE_FINALIZACION = 2,
+    FASE_COMPLETADO = 3     //Fin del ciclo: unidades contiene lo obtenido
+};
+
+//Evento binario de tamaño fijo que un equipo publica en su anillo; el coordinador le da formato
+struct EventoEquipo {
+    int32_t equipo;         //Identificador del equipo
+    int32_t pid;            //PID del proceso que lo publicó
+    int32_t fase;           //FaseEquipo
+    int32_t unidades;       //Unidades obtenidas (solo FASE_COMPLETADO)
+    int32_t t_simulado;     //Segundo simulado del día en que ocurre (ordena la salida)
+    int32_t relleno;
+    int64_t t_ns;           //Instante real (CLOCK_MONOTONIC) en que se publicó
+};
+
+//Capacidad de cada anillo (potencia de 2); un equipo publica 4 eventos por día y el coordinador
+//vacía los anillos al cerrar cada día, así que nunca se llena en uso normal
+const uint32_t CAPACIDAD_ANILLO = 8;
+
+//Anillo de eventos de un solo productor (el equipo) y un solo consumidor (el coordinador), sin bloqueos
+//cabeza solo la escribe el equipo y cola solo el coordinador, cada una en su propia línea de caché
+struct alignas(64) AnilloEventos {
+    alignas(64) uint32_t cabeza;      //Eventos publicados (productor)
+    uint32_t descartados;             //Eventos perdidos por anillo lleno (productor)
+    alignas(64) uint32_t cola;        //Eventos consumidos (consumidor)
+    alignas(64) EventoEquipo eventos[CAPACIDAD_ANILLO];
+};
+
+//Histograma de tiempos con cubetas logarítmicas: 4 subcubetas por potencia de 2 (error relativo < 25%)
+//Registrar una muestra es un conteo de ceros y un incremento: sin memoria dinámica ni ordenamientos
+const int CUBETAS_HISTOGRAMA = 256;
+struct HistogramaLog {
+    uint64_t cubetas[CUBETAS_HISTOGRAMA];
+    uint64_t muestras;
+    long long maximo;  //Mayor muestra registrada (ns)
+};
+
+//Cubeta de un valor: los valores 0..3 tienen cubeta propia; desde 4, (octava - 1) * 4 + 2 bits siguientes
+inline int cubeta_histograma(uint64_t valor) {
+    if (valor < 4) return (int) valor;
+    int octava = 63 - __builtin_clzll(valor);
+    return (octava - 1) * 4 + (int) ((valor >> (octava - 2)) & 3);
+}
+
+//Mayor valor que cae en la cubeta indice
+inline long long limite_cubeta(int indice) {
+    if (indice < 4) return indice;
+    int octava = indice / 4 + 1, sub = indice % 4;
+    return ((long long) (4 + sub + 1) << (octava - 2)) - 1;
+}
+
+//Agrega una muestra (en ns; las negativas cuentan como 0)
+inline void registrar_muestra(HistogramaLog& h, long long ns) {
+    if (ns < 0) ns = 0;
+    ++h.cubetas[cubeta_histograma((uint64_t) ns)];
+    ++h.muestras;
+    if (ns > h.maximo) h.maximo = ns;
+}
+
+//Percentil q (0..1) aproximado por el límite superior de su cubeta, acotado por el máximo
+long long percentil_histograma(const HistogramaLog& h, double q) {
+    if (h.muestras == 0) return 0;
+    uint64_t objetivo = (uint64_t) ceil(q * h.muestras), acumulado = 0;
+    if (objetivo == 0) objetivo = 1;
+    for (int c = 0; c < CUBETAS_HISTOGRAMA; ++c) {
+        acumulado += h.cubetas[c];
+        if (acumulado >= objetivo) return min(limite_cubeta(c), h.maximo);
+    }
+    return h.maximo;
+}
+
+//Tramos del día que se miden (--stats)
+enum TramoDia {
+    TRAMO_ARRANQUE = 0,   //fork (o liberación de la barrera) hasta que el equipo ejecuta
+    TRAMO_ENLACE,         //Entrada del equipo hasta el inicio de sus fases (shmat en el modo fork)
+    TRAMO_EXPLORACION,    //Fase de exploración (tiempo real)
+    TRAMO_RECOLECCION,    //Fase de recolección
+    TRAMO_FINALIZACION,   //Fase de finalización, sorteo y reporte
+    TRAMO_DESPERTAR,      //Último equipo termina hasta que el coordinador lo nota
+    TRAMO_RECOGER,        //Recoger a un equipo al cerrar el día (waitpid de un hijo o join de un hilo)
+    TRAMO_DIA,            //Día completo visto por el coordinador
+    NUM_TRAMOS
+};
+
+//Bloque de estadísticas en la memoria compartida: los equipos dejan sus instantes en su reporte y
+//el coordinador (único escritor de este bloque) los agrega al cerrar cada día
+struct EstadisticasTramos {
+    HistogramaLog tramos[NUM_TRAMOS];
 };
 
+//Ranuras de reportes en la memoria compartida (doble buffer: días pares e impares)
+const int NUM_RANURAS_REPORTE = 2;
+
 //Estructura completa de la memoria compartida entre procesos
+//El segmento se dimensiona en tiempo de ejecución: cabecera + NUM_RANURAS_REPORTE * num_equipos
+//reportes + num_equipos anillos de eventos (ver tamano_memoria, reportes_dia y anillo_equipo)
 struct SharedMemoryData {
-    ReporteEquipo reportes[4]; //Array o 'lista' de reportes de los 4 equipos
-    int equipos_completados;  //Contador de equipos que han terminado su trabajo
+    int num_equipos;          //Cantidad de equipos (y de reportes al final del segmento)
     int dia_actual;           //Día actual de la simulación
+    int ciclo_inicio;         //Barrera de inicio (futex): último día liberado por el coordinador (modo persistente)
+    int evento_fd;            //eventfd heredado por los hijos: el último equipo en terminar lo señaliza
+    long long t_ultimo_ns;    //Instante en que el último equipo del día incrementó equipos_completados
+    double escala_tiempo;     //Segundos reales por segundo simulado (0: instantáneo)
+    uint64_t semilla;         //Semilla global de los generadores basados en contador
+    int silencioso;           //1: los equipos no escriben mensajes de sus fases
+    int falla_equipo;         //Falla inyectada (--inject-fault): equipo, día (0: ninguna), modo y si sigue pendiente
+    int falla_dia;
+    int falla_colgar;         //0: el equipo muere a mitad del día; 1: se cuelga sin reportar
+    int falla_pendiente;      //Se consume al dispararse, así el equipo relanzado trabaja normalmente
+    EstadisticasTramos estadisticas; //Histogramas de los tramos del día (solo los escribe el coordinador)
+    alignas(64) int equipos_completados; //Contador de equipos que han terminado su trabajo (línea de caché propia)
+    ReporteEquipo reportes[]; //Reportes, NUM_RANURAS_REPORTE ranuras de num_equipos (miembro flexible)
+};
+
+//Tamaño en bytes del segmento de memoria compartida para num_equipos equipos
+size_t tamano_memoria(int num_equipos) {
+    return sizeof(SharedMemoryData) +
+           (size_t) num_equipos * (NUM_RANURAS_REPORTE * sizeof(ReporteEquipo) + sizeof(AnilloEventos));
+}
+
+//Ranura de reportes del día dia: los días alternan entre las dos ranuras, así los equipos pueden
+//escribir el día d+1 mientras el coordinador todavía lee el día d (--pipeline)
+inline ReporteEquipo* reportes_dia(SharedMemoryData* shared_data, int dia) {
+    return shared_data->reportes + (size_t) (dia % NUM_RANURAS_REPORTE) * shared_data->num_equipos;
+}
+
+//Anillo de eventos del equipo equipo_id (los anillos van a continuación de los reportes)
+inline AnilloEventos* anillo_equipo(SharedMemoryData* shared_data, int equipo_id) {
+    return (AnilloEventos*) (shared_data->reportes + (size_t) NUM_RANURAS_REPORTE * shared_data->num_equipos) + equipo_id;
+}
+
+//Valor de ciclo_inicio que indica a los equipos persistentes que deben terminar
+const int CICLO_TERMINAR = -1;
+
+//Supervisión de los hijos: etiqueta del eventfd en el epoll del coordinador (los pidfd llevan el
+//índice del equipo) y relanzamientos permitidos por equipo y día antes de darlo por fallido
+const uint64_t ETIQUETA_EVENTFD = UINT64_MAX;
+const int MAX_REINTENTOS_DIA = 1;
+
+//Forma en que termina una simulación
+enum FinSimulacion {
+    FIN_RESCATE = 0,       //Señales suficientes durante DIAS_RESCATE días consecutivos
+    FIN_COLAPSO_MORAL = 1, //La moral llegó a 0
+    FIN_LIMITE_TIEMPO = 2  //Se alcanzó el número de días sin rescate ni colapso
+};
+
+//Opciones de ejecución leídas desde la línea de comandos
+struct OpcionesSimulacion {
+    int dias_simulacion = 0;            //Días a simular (0: solicitar interactivamente)
+    bool equipos_persistentes = false;  //true: los equipos se crean una vez y sirven todos los días
+    bool espera_polling = false;        //true: el coordinador espera con el sondeo de 100ms original
+    double escala_tiempo = 1.0;         //Segundos reales por segundo simulado (0: sin pausas reales)
+    long long corridas = 0;             //Modo batch: número de simulaciones independientes (0: modo normal)
+    int hilos = 0;                      //Modo batch: hilos del pool (0: núcleos disponibles)
+    uint64_t semilla = 0;               //Semilla global (--seed); sin --seed se toma de random_device
+    bool bench_rng = false;             //Microbenchmark de sorteos por segundo (legado vs contador)
+    bool lockstep = false;              //Modo batch: motor SoA que avanza miles de corridas a la vez
+    string simd = "auto";               //Kernel del motor lockstep: auto, avx2, sse41 o escalar
+    bool silencioso = false;            //true: sin salida por día (solo el resultado final y las estadísticas)
+    bool solo_metricas = false;         //Uso interno (--scaling): sin encabezado ni resumen, solo métricas
+    string archivo_config;              //Archivo de configuración de equipos y recursos (--config)
+    int num_equipos = 0;                //Equipos a simular (--teams; 0: los de la configuración)
+    bool escalamiento = false;          //Mide cómo escala la latencia por día con la cantidad de equipos
+    string archivo_traza;               //Graba cada día en una traza binaria columnar (--trace)
+    string archivo_replay;              //Reproduce la salida de consola desde una traza (--replay)
+    string archivo_consulta;            //Consultas agregadas sobre una traza (--query)
+    long long corrida_replay = 0;       //Corrida a reproducir con --replay (--run; 0 en el modo normal)
+    bool exacto = false;                //Probabilidades exactas por cadena de Markov (--exact)
+    bool bench = false;                 //Suite de microbenchmarks con salida JSON (--bench)
+    bool estadisticas = false;          //Histogramas de los tramos del día al final (--stats)
+    string backend = "procesos";        //Ejecución de los equipos: procesos, hilos o pool (--backend)
+    bool eventos_discretos = false;     //Equipos como corrutinas en un motor de eventos discretos (--des)
+    bool pipeline = false;              //Lanzar el día siguiente mientras se evalúa y muestra el actual (--pipeline)
+    string estimador;                   //Estimador de varianza reducida con --runs (--estimator); vacío: batch simple
+    string archivo_variante;            //Configuración variante para el estimador crn (--variant)
+    FinSimulacion objetivo_importancia = FIN_COLAPSO_MORAL; //Término buscado por el muestreo por importancia (--is-target)
+    double inclinacion = -1;            //Probabilidad del nivel favorecido (--is-tilt; -1: 0.3 colapso, 0.35 rescate)
+    vector<string> parametros;          //Parámetros de las reglas fijados con --set NOMBRE=VALOR
+    string barrido;                     //Especificación de --sweep (nombre=desde:hasta[:paso],...)
+    double banda_min = -1, banda_max = -1; //Banda objetivo de la tasa de rescate en % (--target LO:HI)
+    bool busqueda = false;              //Búsqueda local en lugar de la grilla completa (--search)
+    long long dias_flujo = 0;           //Días totales del modo de flujo continuo (--stream; 0: desactivado)
+    string archivo_instantaneas;        //Archivo de instantáneas JSON del modo de flujo (--snapshot)
+    long long dias_entre_instantaneas = 0; //Días entre instantáneas (--snapshot-every; 0: DIAS_ENTRE_INSTANTANEAS)
+    string archivo_punto_control;       //Punto de control del modo batch o de flujo continuo (--checkpoint)
+    long long puntos_cada = 0;          //Corridas o días entre guardados (--checkpoint-every; 0: por defecto)
+    bool reanudar = false;              //Retomar desde el punto de control (--resume)
+    vector<int> cpus;                   //CPUs del coordinador y los equipos (--cpus; vacío: sin fijar)
+    string politica;                    //Política de planificación (--sched fifo|alta; vacío: normal)
+    bool numa = false;                  //Memoria de la simulación en el nodo NUMA del coordinador (--numa)
+    bool comparar_jitter = false;       //Compara el jitter por día sin y con --cpus/--sched/--numa (--jitter)
+    long long plazo_ms = -1;            //Plazo real por día en ms para la supervisión (-1: automático, 0: sin plazo)
+    int falla_equipo = 0;               //Falla inyectada (--inject-fault E:D[:hang]): equipo, día (0: ninguna)
+    int falla_dia = 0;
+    bool falla_colgar = false;          //El equipo se cuelga en lugar de morir
+};
+
+//Métricas de tiempo real que retorna el coordinador
+struct MetricasCoordinador {
+    int dias_medidos;           //Días efectivamente simulados
+    double latencia_dia_us;     //Tiempo real promedio por día (inicio del día hasta reportes recogidos)
+    double sobrecarga_dia_us;   //Sobrecarga de coordinación promedio por día
+    vector<long long> sobrecargas_ns;  //Sobrecarga de cada día (jitter)
+    vector<long long> despertares_ns;  //Latencia de despertar de cada día (jitter)
 };
 
-//Constantes del Sistema
+//Estado de supervivencia que evoluciona día a día
+struct EstadoSupervivencia {
+    int moral;                 //Moral actual del grupo (0-100)
+    int senales_consecutivas;  //Días consecutivos con señales suficientes
+};
+
+//Constantes del Sistema (valores por defecto de la configuración del campamento)
 const int MIN_AGUA = 8;              //min de unidades de agua requeridas por día
 const int MIN_ALIMENTOS = 12;         //min de unidades de alimentos requeridas por día
 const int MIN_CONSTRUCCION = 4;       //min de unidades de construcción requeridas por día
@@ -52,481 +309,4430 @@ const int MORAL_INICIAL = 100;        //min de moral iniciales del grupo
 const int DIAS_RESCATE = 10;          //dias consecutivos con señales para rescate exitoso
 const int MAX_DIAS = 30;              //max número de días de simulación
 const int MIN_DIAS = 10;              //min número de días de simulación
+const int MAX_EQUIPOS = 4096;         //max número de equipos de una configuración
+const int MAX_EQUIPOS_EVENTOS = 1 << 20; //max número de equipos con el motor de eventos (--des --teams N)
+const int MAX_EQUIPOS_DETALLE = 64;   //max equipos con promedios por equipo en el resumen del motor de eventos
+
+
+//Reglas de supervivencia: mínimos diarios, penalizaciones por unidad faltante y condiciones de término
+struct ReglasSupervivencia {
+    int minimo[NUM_RECURSOS];        //Unidades mínimas requeridas por día de cada recurso
+    int penalizacion[NUM_RECURSOS];  //Moral perdida por cada unidad faltante de cada recurso
+    int moral_inicial;               //Moral con la que parte el grupo
+    int dias_rescate;                //Días consecutivos con señales suficientes para el rescate
+};
+
+//Textos de un tipo de recurso para la salida por consola
+struct DescripcionRecurso {
+    string clave;      //Nombre usado en el archivo de configuración ("agua")
+    string etiqueta;   //Etiqueta en RESULTADOS DEL DÍA ("Agua recolectada")
+    string razon;      //Razón de penalización ("falta de agua")
+};
+
+//Equipo de recolección: recurso al que aporta, rango de unidades base y mensajes de sus fases
+struct TipoEquipo {
+    string nombre;          //Nombre en los mensajes de fase ("AGUA")
+    string nombre_reporte;  //Nombre en los reportes finales ("Agua")
+    int recurso;            //TipoRecursoId al que suma sus unidades
+    int base_min;           //Unidades base mínimas (antes de aplicar el porcentaje de éxito)
+    int base_max;           //Unidades base máximas
+    string exploracion;     //Mensaje de la fase de exploración
+    string recoleccion;     //Mensaje de la fase de recolección
+    string finalizacion;    //Mensaje de la fase de finalización
+};
+
+//Configuración completa del campamento (equipos y recursos), cargada antes de crear procesos o hilos
+struct ConfiguracionCampamento {
+    ReglasSupervivencia reglas;
+    DescripcionRecurso recursos[NUM_RECURSOS];
+    vector<TipoEquipo> equipos;
+};
+
+//Configuración por defecto: los 4 equipos y mínimos originales del simulador
+ConfiguracionCampamento configuracion_predeterminada() {
+    ConfiguracionCampamento config;
+    config.reglas = {
+        {MIN_AGUA, MIN_ALIMENTOS, MIN_CONSTRUCCION, MIN_SENALES}, // Mínimos diarios
+        {3, 2, 1, 2},                                             // Penalización por unidad faltante
+        MORAL_INICIAL, DIAS_RESCATE };
+    config.recursos[RECURSO_AGUA] = {"agua", "Agua recolectada", "falta de agua"};
+    config.recursos[RECURSO_ALIMENTOS] = {"alimentos", "Alimentos obtenidos", "falta de comida"};
+    config.recursos[RECURSO_CONSTRUCCION] = {"construccion", "Materiales de construcción", "falta de refugio"};
+    config.recursos[RECURSO_SENALES] = {"senales", "Señales mantenidas", "señales insuficientes"};
+    config.equipos = {
+        {"AGUA", "Agua", RECURSO_AGUA, 6, 14,
+         "Explorando fuentes de agua...", "Recolectando agua del arroyo encontrado...", "Purificando agua recolectada..."},
+        {"ALIMENTOS", "Alimentos", RECURSO_ALIMENTOS, 10, 20,
+         "Explorando territorio para cazar...", "Intentando pescar en la laguna...", "¡Capturado pez pequeño! Preparando..."},
+        {"CONSTRUCCION", "Construcción", RECURSO_CONSTRUCCION, 4, 12,
+         "Buscando materiales de construcción...", "Cortando ramas útiles...", "Construyendo refugio básico..."},
+        {"SEÑALES", "Señales", RECURSO_SENALES, 2, 8,
+         "Recolectando combustible seco...", "Manteniendo fogata de señales...", "Creando señales de humo..."} };
+    return config;
+}
+
+//Configuración vigente; se fija en main() antes de crear procesos o hilos y luego solo se lee
+ConfiguracionCampamento campamento = configuracion_predeterminada();
 
+//Separa una línea del archivo de configuración en campos delimitados por '|'
+vector<string> separar_campos(const string& linea) {
+    vector<string> campos;
+    size_t inicio = 0, fin;
+    while ((fin = linea.find('|', inicio)) != string::npos) {
+        campos.push_back(linea.substr(inicio, fin - inicio));
+        inicio = fin + 1;
+    }
+    campos.push_back(linea.substr(inicio));
+    return campos;
+}
 
-//Nombres de los equipos de recolección
-const vector<string> nombres_equipos = {
-    "AGUA", "ALIMENTOS", "CONSTRUCCION", "SEÑALES" };
+//Busca un recurso por su clave ("agua", "alimentos", ...); retorna -1 si no existe
+int buscar_recurso(const ConfiguracionCampamento& config, const string& clave) {
+    int k; fo(k, NUM_RECURSOS) {
+        if (config.recursos[k].clave == clave) return k;
+    }
+    return -1;
+}
 
-//mensajes de actividades de exploración para cada equipo
-const vector<string> actividades_exploracion = {
-    "Explorando fuentes de agua...",              //equipo Agua
-    "Explorando territorio para cazar...",        //equipo Alimentos
-    "Buscando materiales de construcción...",     //equipo Construcción
-    "Recolectando combustible seco..."  };        //equipo Señales
+//Carga equipos y reglas desde un archivo de texto, partiendo de la configuración por defecto
+//Formato (una entrada por línea, campos separados por '|', '#' inicia un comentario):
+//  recurso|<clave>|<mínimo>|<penalización>[|<etiqueta>|<razón>]
+//  equipo|<NOMBRE>|<Nombre reporte>|<clave recurso>|<base mín>|<base máx>|<exploración>|<recolección>|<finalización>
+//  moral_inicial|<N>
+//  dias_rescate|<N>
+//Si el archivo define al menos un equipo, su lista reemplaza a los 4 equipos por defecto
+//Retorna false y deja un mensaje en error si el archivo no se puede leer o tiene una línea inválida
+bool cargar_configuracion(const string& ruta, ConfiguracionCampamento& config, string& error) {
+    ifstream archivo(ruta);
+    if (!archivo) {
+        error = "no se pudo abrir " + ruta;
+        return false;
+    }
+    vector<TipoEquipo> equipos;
+    string linea;
+    int num_linea = 0;
+    while (getline(archivo, linea)) {
+        ++num_linea;
+        size_t comentario = linea.find('#');
+        if (comentario != string::npos) linea.erase(comentario);
+        if (linea.find_first_not_of(" \t\r") == string::npos) continue;  // Línea vacía
 
-//mensajes de actividades de recolección para cada equipo
-const vector<string> actividades_recoleccion = {
-    "Recolectando agua del arroyo encontrado...", // Equipo Agua
-    "Intentando pescar en la laguna...",          // Equipo Alimentos
-    "Cortando ramas útiles...",                   // Equipo Construcción
-    "Manteniendo fogata de señales..." };         // Equipo Señales
+        vector<string> c = separar_campos(linea);
+        string posicion = ruta + ":" + to_string(num_linea) + ": ";
+        if (c[0] == "recurso" && (c.size() == 4 || c.size() == 6)) {
+            int k = buscar_recurso(config, c[1]);
+            if (k < 0) {
+                error = posicion + "recurso desconocido '" + c[1] + "'";
+                return false;
+            }
+            config.reglas.minimo[k] = atoi(c[2].c_str());
+            config.reglas.penalizacion[k] = atoi(c[3].c_str());
+            if (c.size() == 6) {
+                config.recursos[k].etiqueta = c[4];
+                config.recursos[k].razon = c[5];
+            }
+        } else if (c[0] == "equipo" && c.size() == 9) {
+            int k = buscar_recurso(config, c[3]);
+            int base_min = atoi(c[4].c_str()), base_max = atoi(c[5].c_str());
+            if (k < 0 || base_min < 0 || base_max < base_min) {
+                error = posicion + "equipo inválido (recurso desconocido o rango de unidades incorrecto)";
+                return false;
+            }
+            equipos.push_back({c[1], c[2], k, base_min, base_max, c[6], c[7], c[8]});
+        } else if (c[0] == "moral_inicial" && c.size() == 2) {
+            config.reglas.moral_inicial = atoi(c[1].c_str());
+        } else if (c[0] == "dias_rescate" && c.size() == 2) {
+            config.reglas.dias_rescate = atoi(c[1].c_str());
+        } else {
+            error = posicion + "línea no reconocida";
+            return false;
+        }
+    }
+    if (!equipos.empty()) config.equipos = equipos;
+    if ((int) config.equipos.size() > MAX_EQUIPOS) {
+        error = "demasiados equipos (máximo " + to_string(MAX_EQUIPOS) + ")";
+        return false;
+    }
+    if (config.reglas.moral_inicial <= 0 || config.reglas.dias_rescate <= 0) {
+        error = "moral_inicial y dias_rescate deben ser mayores que 0";
+        return false;
+    }
+    return true;
+}
 
+//Fija un parámetro de las reglas por nombre (--set y --sweep):
+//  minimo.<clave recurso>, penalizacion.<clave recurso>, moral_inicial, dias_rescate
+//Retorna false y deja un mensaje en error si el nombre no existe o el valor está fuera de rango
+bool fijar_parametro(const ConfiguracionCampamento& config, ReglasSupervivencia& reglas, const string& nombre,
+                     int valor, string& error) {
+    size_t punto = nombre.find('.');
+    string campo = nombre.substr(0, punto);
+    if (punto != string::npos && (campo == "minimo" || campo == "penalizacion")) {
+        int k = buscar_recurso(config, nombre.substr(punto + 1));
+        if (k < 0) {
+            error = "recurso desconocido en '" + nombre + "'";
+            return false;
+        }
+        if (valor < 0) {
+            error = nombre + " debe ser >= 0";
+            return false;
+        }
+        (campo == "minimo" ? reglas.minimo : reglas.penalizacion)[k] = valor;
+    } else if (nombre == "moral_inicial" && punto == string::npos) {
+        if (valor <= 0) {
+            error = "moral_inicial debe ser mayor que 0";
+            return false;
+        }
+        reglas.moral_inicial = valor;
+    } else if (nombre == "dias_rescate" && punto == string::npos) {
+        if (valor <= 0) {
+            error = "dias_rescate debe ser mayor que 0";
+            return false;
+        }
+        reglas.dias_rescate = valor;
+    } else {
+        error = "parámetro desconocido '" + nombre + "' (minimo.<recurso>, penalizacion.<recurso>, moral_inicial, dias_rescate)";
+        return false;
+    }
+    return true;
+}
 
-// Mensajes de actividades de finalización para cada equipo
-const vector<string> actividades_finalizacion = {
-    "Purificando agua recolectada...",            // Equipo Agua
-    "¡Capturado pez pequeño! Preparando...",      // Equipo Alimentos
-    "Construyendo refugio básico...",             // Equipo Construcción
-    "Creando señales de humo..."      };          // Equipo Señales
+//Replica cíclicamente la tabla de equipos hasta tener num_equipos (--teams)
+//Las copias llevan un sufijo numérico en el nombre ("AGUA-2", "AGUA-3", ...)
+vector<TipoEquipo> replicar_equipos(const vector<TipoEquipo>& base, int num_equipos) {
+    vector<TipoEquipo> equipos;
+    for (int i = 0; i < num_equipos; ++i) {
+        TipoEquipo equipo = base[i % base.size()];
+        int copia = i / (int) base.size();
+        if (copia > 0) {
+            equipo.nombre += "-" + to_string(copia + 1);
+            equipo.nombre_reporte += "-" + to_string(copia + 1);
+        }
+        equipos.push_back(equipo);
+    }
+    return equipos;
+}
 
 
 //Funciones de Generación Aleatoria
 
+//Flujos independientes de números aleatorios para un mismo (corrida, día, equipo)
+enum FlujoAleatorio {
+    FLUJO_RESULTADO = 1,  //Sorteo del porcentaje de éxito (generar_resultado)
+    FLUJO_UNIDADES = 2,   //Sorteo de unidades base y bonus (calcular_unidades)
+    FLUJO_TIEMPOS = 3     //Sorteo de las duraciones de las fases (trabajar_dia)
+};
+
+//Función de mezcla de splitmix64: biyección de 64 bits con buena difusión
+inline uint64_t mezclar64(uint64_t z) {
+    z += 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+//Generador aleatorio basado en contador (estilo splitmix64)
+//No tiene estado interno costoso: el n-ésimo número es mezclar64(clave + n * φ), por lo que crearlo
+//cuesta unas pocas multiplicaciones (frente a los ~5 KB de estado de mt19937 y la llamada al
+//sistema de random_device) y la secuencia queda fijada por (semilla global, corrida, día, equipo, flujo)
+struct GeneradorContador {
+    uint64_t clave;     //Clave derivada de (semilla, corrida, día, equipo, flujo)
+    uint64_t contador;  //Posición dentro del flujo (números ya entregados)
+    bool antitetico;    //Entrega el reflejo a + b - x de cada sorteo uniforme (variable antitética)
+
+    GeneradorContador(uint64_t semilla, uint64_t corrida, int dia, int equipo_id, FlujoAleatorio flujo)
+        : clave(mezclar64(semilla ^ mezclar64(corrida ^ mezclar64(((uint64_t) (uint32_t) dia << 32) |
+                                                                  ((uint64_t) (uint32_t) equipo_id << 8) |
+                                                                  (uint64_t) flujo)))),
+          contador(0), antitetico(false) {}
+
+    //Siguiente número de 64 bits del flujo
+    uint64_t siguiente() {
+        return mezclar64(clave + (++contador) * 0x9e3779b97f4a7c15ULL);
+    }
+
+    //Entero uniforme en [a, b] (método de Lemire con rechazo: sin sesgo y sin divisiones en el caso común)
+    int uniforme(int a, int b) {
+        uint32_t rango = (uint32_t) (b - a + 1);
+        uint64_t m = (uint64_t) (uint32_t) (siguiente() >> 32) * rango;
+        uint32_t bajo = (uint32_t) m;
+        if (bajo < rango) {
+            uint32_t umbral = (uint32_t) (-rango) % rango;
+            while (bajo < umbral) {
+                m = (uint64_t) (uint32_t) (siguiente() >> 32) * rango;
+                bajo = (uint32_t) m;
+            }
+        }
+        int x = a + (int) (m >> 32);
+        return antitetico ? a + b - x : x;
+    }
+};
+
+//Obtiene una semilla global desde la entropía del sistema (una sola vez por ejecución, si no se usa --seed)
+uint64_t semilla_aleatoria() {
+    random_device rd;
+    return ((uint64_t) rd() << 32) ^ rd() ^ (uint64_t) time(nullptr) ^ ((uint64_t) getpid() << 16);
+}
+
 //Genera un porcentaje de éxito aleatorio basado en probabilidades definidas
-//dia actual de la simulación (influye en la semilla aleatoria)
-//equipo_id Identificador del equipo (0-3) (influye en la semilla aleatoria)
+//gen Generador del flujo FLUJO_RESULTADO para este (corrida, día, equipo)
+//dia actual de la simulación y equipo_id introducen un sesgo contextual en la probabilidad
 //Porcentaje de éxito (100: éxito total, 50-80: éxito parcial, 5-29: fracaso)
 //Probabilidades: 30% éxito total, 50% éxito parcial, 20% fracaso
- //Usa una combinación única de semillas para garantizar variabilidad entre ejecuciones
-
-// Genera un porcentaje de éxito para un equipo en un día específico, simulando variabilidad realista
-int generar_resultado(int dia, int equipo_id) {
-    // Se construye una semilla única para cada proceso hijo, combinando:
-    // - random_device: fuente de entropía del sistema (si está disponible)
-    // - time(nullptr): tiempo actual en segundos
-    // - getpid(): ID del proceso, desplazado para mayor dispersión
-    // - dia y equipo_id: parámetros que introducen variabilidad contextual
-    random_device rd; //std::random_device rd;
-    unsigned int seed = rd() ^ static_cast<unsigned int>(time(nullptr)) ^
-                        (getpid() << 8) ^ (dia * 31) ^ (equipo_id * 97); // formula de semilla
-
-    // Se inicializa el generador Mersenne Twister con la semilla compuesta
-    mt19937 gen(seed); //std::mt19937 gen(seed);
-
+int generar_resultado(GeneradorContador& gen, int dia, int equipo_id) {
     // Se define una distribución uniforme entre 1 y 100 para simular probabilidad base
-    uniform_int_distribution<> dis(1, 100); //std::uniform_int_distribution<> dis(1, 100);
-    int probabilidad = dis(gen);
+    // (sorteo crudo, sin reflejo: en la variable antitética el reflejo se aplica una sola vez, después del sesgo)
+    bool reflejar = gen.antitetico;
+    gen.antitetico = false;
+    int probabilidad = gen.uniforme(1, 100);
+    gen.antitetico = reflejar;
 
     // Se ajusta la probabilidad con un sesgo adicional dependiente del día y equipo,
     // asegurando que el resultado final esté en el rango [1, 100]
     probabilidad = (probabilidad + dia * 7 + equipo_id * 13) % 100 + 1;
 
+    // Variable antitética: se refleja el nivel ya sesgado (el sesgo rota 1..100, así que reflejar el
+    // sorteo crudo no daría el nivel opuesto)
+    if (reflejar) probabilidad = 101 - probabilidad;
+
     
     if (probabilidad <= 30) {//30% de probabilidad de éxito total (100%)
         return 100; // Éxito total
     } else if (probabilidad <= 80) {
-        uniform_int_distribution<> partial_dis(50, 80);//50% de probabilidad de éxito parcial (entre 50% y 80%)
-        return partial_dis(gen); // Éxito parcial
+        return gen.uniforme(50, 80); // Éxito parcial: 50% de probabilidad (entre 50% y 80%)
     } else {
-        uniform_int_distribution<> fail_dis(5, 29);//20% de probabilidad de fracaso (entre 5% y 29%)
-        return fail_dis(gen); // Fracaso
+        return gen.uniforme(5, 29); // Fracaso: 20% de probabilidad (entre 5% y 29%)
     }
 }
 
 
 //Calcula las unidades recolectadas basadas en el porcentaje de éxito y tipo de equipo
+//gen Generador del flujo FLUJO_UNIDADES para este (corrida, día, equipo)
 //porcentaje es de éxito obtenido (de 0 a 100)
-//equipo_id Identificador del equipo (0-3) que determina el rango base
-//dia, Día actual de la simulación (influye en la semilla aleatoria)
+//equipo Tipo de equipo, cuyo rango [base_min, base_max] determina las unidades base
 //int Cantidad de unidades recolectadas (siempre >= 0)
 
-//Cada equipo tiene un rango diferente de unidades base:
+//En la configuración por defecto cada equipo tiene un rango diferente de unidades base:
 //Agua: 6-14 unidades base
-//Alimentos: 8-20 unidades base  
+//Alimentos: 10-20 unidades base  
 //Construcción: 4-12 unidades base
 // Señales: 2-8 unidades base
-int calcular_unidades(int porcentaje, int equipo_id, int dia) {
-    random_device rd; // random_device para obtener entropía del sistema
-    unsigned int seed = rd() ^ static_cast<unsigned int>(time(nullptr)) ^ 
-                      (getpid() << 9) ^ (dia * 17) ^ (equipo_id * 41); // fórmula de semilla única
-    mt19937 gen(seed); // Inicializar generador Mersenne Twister con la semilla
-
-    int objetivo_base; // Unidades base antes de aplicar porcentaje y variación
-    // Diferentes rangos por tipo de equipo para simular especialización
-    switch (equipo_id) { //switch para diferentes equipos, en cada caso
-        case 0: { 
-            uniform_int_distribution<> dis(6, 14); // Equipo Agua: 6-14 unidades base
-            objetivo_base = dis(gen); // Generar unidades base aleatorias
-            break;  
-        }
-        case 1: { 
-            uniform_int_distribution<> dis(10, 20); // Equipo Alimentos: 10-20 unidades base
-            objetivo_base = dis(gen); 
-            break; 
-        }
-        case 2: { // Equipo Construcción: 4-12 unidades base
-            uniform_int_distribution<> dis(4, 12); 
-            objetivo_base = dis(gen); 
-            break; 
-        }
-        case 3: { // Equipo Señales: 2-8 unidades base
-            uniform_int_distribution<> dis(2, 8);  
-            objetivo_base = dis(gen); 
-            break; 
-        }
-        default: objetivo_base = 5;  // Valor por defecto (no debería ocurrir), por seguridad y evitar warnings
-    }
+int calcular_unidades(GeneradorContador& gen, int porcentaje, const TipoEquipo& equipo) {
+    // Unidades base antes de aplicar porcentaje y variación (rango propio de cada equipo)
+    int objetivo_base = gen.uniforme(equipo.base_min, equipo.base_max);
 
     // Aplicar porcentaje de éxito al objetivo base
     int unidades_finales = (objetivo_base * porcentaje) / 100; 
     
     // Pequeña variación aleatoria adicional (0 a +2 unidades)
-    uniform_int_distribution<> bonus_dis(0, 2);
-    unidades_finales += bonus_dis(gen);
+    unidades_finales += gen.uniforme(0, 2);
 
     // Asegurar que no sea negativo (fallo absoluto puede dar 0 unidades)
     if (unidades_finales < 0) unidades_finales = 0;
     return unidades_finales;
 }
 
-//Función del Equipo (Proceso Hijo)
-//Función ejecutada por cada proceso hijo (equipo de recolección)
-//equipo_id Identificador del equipo (0-3)
-//shm_id Identificador del segmento de memoria compartida
-//dia Día actual de la simulación
+//Sortea las unidades de un equipo en un día: porcentaje de éxito y luego unidades,
+//cada uno con su propio flujo para que sean independientes y reproducibles
+//antitetico: sorteos reflejados de la misma corrida (estimador antitético)
+int sortear_unidades(uint64_t semilla, uint64_t corrida, int dia, int equipo_id, bool antitetico = false) {
+    GeneradorContador gen_resultado(semilla, corrida, dia, equipo_id, FLUJO_RESULTADO);
+    GeneradorContador gen_unidades(semilla, corrida, dia, equipo_id, FLUJO_UNIDADES);
+    gen_resultado.antitetico = gen_unidades.antitetico = antitetico;
+    return calcular_unidades(gen_unidades, generar_resultado(gen_resultado, dia, equipo_id),
+                             campamento.equipos[equipo_id]);
+}
 
-//Cada equipo realiza tres fases: exploración, recolección y finalización
-//Los resultados se escriben en la memoria compartida para que el coordinador los lea
-//El proceso termina después de completar su trabajo y reportar resultados
-void equipo_recoleccion(int equipo_id, int shm_id, int dia) {
-    pid_t pid = getpid();  // Obtener PID único del proceso
+//Sortea las unidades de todos los equipos en un día y las acumula por tipo de recurso
+inline Recursos sortear_dia(uint64_t semilla, uint64_t corrida, int dia, bool antitetico = false) {
+    Recursos recursos_dia = {{0, 0, 0, 0}};
+    int num_equipos = (int) campamento.equipos.size();
+    for (int e = 0; e < num_equipos; ++e) {
+        recursos_dia.cantidad[campamento.equipos[e].recurso] += sortear_unidades(semilla, corrida, dia, e, antitetico);
+    }
+    return recursos_dia;
+}
 
-    // Conectar a memoria compartida (usando el shmid pasado por el padre)
-    SharedMemoryData* shared_data = (SharedMemoryData*) shmat(shm_id, NULL, 0); // el shared_data es un puntero a la estructura de memoria compartida
-    if (shared_data == (void*) -1) {
-        perror("shmat (hijo)");  // Error al conectar a memoria compartida
-        exit(1); // Terminar proceso hijo en caso de error
+//Devuelve el instante actual del reloj monotónico en nanosegundos
+//CLOCK_MONOTONIC es común a todos los procesos, por lo que los instantes de padre e hijos son comparables
+long long ahora_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+//Avanza el reloj virtual: duerme segundos_simulados * escala segundos reales (nada si escala es 0)
+//La duración simulada se registra siempre, independiente de la escala
+void esperar_simulado(int segundos_simulados, double escala) {
+    if (escala <= 0) return;
+    double segundos_reales = segundos_simulados * escala;
+    struct timespec ts;
+    ts.tv_sec = (time_t) segundos_reales;
+    ts.tv_nsec = (long) ((segundos_reales - ts.tv_sec) * 1e9);
+    while (nanosleep(&ts, &ts) == -1 && errno == EINTR) {} // Reanudar si una señal interrumpe la pausa
+}
+
+//Bloquea al proceso mientras *direccion siga valiendo valor_esperado (futex compartido entre procesos)
+void futex_esperar(int* direccion, int valor_esperado) {
+    syscall(SYS_futex, direccion, FUTEX_WAIT, valor_esperado, NULL, NULL, 0);
+}
+
+//Despierta a todos los procesos bloqueados en el futex de direccion
+void futex_despertar(int* direccion) {
+    syscall(SYS_futex, direccion, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+//Publica un nuevo valor de la barrera de inicio y despierta a los equipos persistentes
+void liberar_ciclo(SharedMemoryData* shared_data, int valor) {
+    __atomic_store_n(&shared_data->ciclo_inicio, valor, __ATOMIC_RELEASE);
+    futex_despertar(&shared_data->ciclo_inicio);
+}
+
+//Publica un evento en el anillo del equipo (lado productor, sin bloqueos ni llamadas al sistema)
+//Si el anillo está lleno el evento se descarta y se cuenta, para que el equipo nunca espere al coordinador
+void publicar_evento(SharedMemoryData* shared_data, int equipo_id, pid_t pid, FaseEquipo fase,
+                     int t_simulado, int unidades) {
+    AnilloEventos* anillo = anillo_equipo(shared_data, equipo_id);
+    uint32_t cabeza = anillo->cabeza;  // Solo este equipo la escribe
+    if (cabeza - __atomic_load_n(&anillo->cola, __ATOMIC_ACQUIRE) == CAPACIDAD_ANILLO) {
+        __atomic_fetch_add(&anillo->descartados, 1, __ATOMIC_RELAXED);
+        return;
     }
+    EventoEquipo& evento = anillo->eventos[cabeza & (CAPACIDAD_ANILLO - 1)];
+    evento.equipo = equipo_id;
+    evento.pid = pid;
+    evento.fase = fase;
+    evento.unidades = unidades;
+    evento.t_simulado = t_simulado;
+    evento.relleno = 0;
+    evento.t_ns = ahora_ns();
+    __atomic_store_n(&anillo->cabeza, cabeza + 1, __ATOMIC_RELEASE);  // Publicar el evento ya escrito
+}
+
+//Retira del anillo los eventos aún no consumidos que publicó pid (un equipo que murió sin reportar y se
+//relanza repite el día, y sus fases saldrían dos veces); solo es seguro con ese productor ya recogido
+void descartar_eventos(SharedMemoryData* shared_data, int equipo_id, pid_t pid) {
+    AnilloEventos* anillo = anillo_equipo(shared_data, equipo_id);
+    uint32_t cola = __atomic_load_n(&anillo->cola, __ATOMIC_ACQUIRE);
+    uint32_t cabeza = anillo->cabeza;
+    while (cabeza != cola && anillo->eventos[(cabeza - 1) & (CAPACIDAD_ANILLO - 1)].pid == pid) --cabeza;
+    __atomic_store_n(&anillo->cabeza, cabeza, __ATOMIC_RELEASE);
+}
+
+//Función del Equipo (trabajo de un día)
+//Ejecuta las tres fases del equipo y escribe el resultado en la memoria compartida
+//shared_data Puntero a la memoria compartida ya enlazada por el proceso
+//equipo_id Identificador del equipo (0 a num_equipos-1)
+//dia Día actual de la simulación
+//t_entrada_ns Instante en que el proceso empezó a ejecutar este día (tras fork o al despertar del futex)
+void trabajar_dia(SharedMemoryData* shared_data, int equipo_id, int dia, long long t_entrada_ns) {
+    pid_t pid = (pid_t) syscall(SYS_gettid);  // PID del proceso del equipo (o TID si el equipo es un hilo)
 
-    // Inicializar reporte del equipo en memoria compartida
+    // Inicializar reporte del equipo en memoria compartida (en la ranura del día)
     // el shared_data es un puntero a la estructura de memoria compartida
-    shared_data->reportes[equipo_id].id_equipo = equipo_id; // Identificador del equipo
-    shared_data->reportes[equipo_id].estado_equipo = 0; // el Estado: trabajando
-    shared_data->reportes[equipo_id].pid_equipo = pid; // el pid del equipo
+    ReporteEquipo& reporte = reportes_dia(shared_data, dia)[equipo_id];
+    reporte.id_equipo = equipo_id; // Identificador del equipo
+    reporte.estado_equipo = 0; // el Estado: trabajando
+    reporte.pid_equipo = pid; // el pid del equipo
+    reporte.t_entrada_ns = t_entrada_ns;
+    reporte.t_inicio_ns = ahora_ns(); // inicio del trabajo útil del día
+
+    bool salida = !shared_data->silencioso; // Los eventos solo se publican si hay salida habilitada
 
     // Fase 1: Exploración
-    cout << "[EQUIPO " << nombres_equipos[equipo_id] << " - PID: " << pid << "] "
-         << actividades_exploracion[equipo_id] << endl;
+    if (salida) publicar_evento(shared_data, equipo_id, pid, FASE_EXPLORACION, 0, 0);
 
-    // Tiempos de espera aleatorios para simular trabajo variable
-    random_device rd; // random_device para obtener entropía del sistema
-    unsigned int seed_sleep = rd() ^ static_cast<unsigned int>(time(nullptr)) ^ 
-                            (pid << 5) ^ (dia * 13); // fórmula de semilla única
-    mt19937 gen_sleep(seed_sleep); // Inicializar generador Mersenne Twister con la semilla
-    uniform_int_distribution<> sleep_dis(1, 4);  // Espera entre 1-4 segundos
+    // Tiempos de espera aleatorios (1-4 segundos simulados) para simular trabajo variable
+    GeneradorContador gen_tiempos(shared_data->semilla, 0, dia, equipo_id, FLUJO_TIEMPOS);
 
-    sleep(sleep_dis(gen_sleep));  // Simular tiempo de exploración
+    reporte.seg_exploracion = gen_tiempos.uniforme(1, 4);
+    esperar_simulado(reporte.seg_exploracion, shared_data->escala_tiempo);  // Simular tiempo de exploración
+
+    // Falla inyectada (--inject-fault): el equipo muere o se cuelga a mitad del día, sin reportar
+    if (shared_data->falla_dia == dia && shared_data->falla_equipo == equipo_id &&
+        __atomic_exchange_n(&shared_data->falla_pendiente, 0, __ATOMIC_ACQ_REL)) {
+        if (shared_data->falla_colgar) {
+            while (true) pause();
+        }
+        raise(SIGKILL);
+    }
 
     // Fase 2: Recolección
-    cout << "[EQUIPO " << nombres_equipos[equipo_id] << " - PID: " << pid << "] "
-         << actividades_recoleccion[equipo_id] << endl;
+    reporte.t_recoleccion_ns = ahora_ns();
+    if (salida) publicar_evento(shared_data, equipo_id, pid, FASE_RECOLECCION, reporte.seg_exploracion, 0);
 
-    sleep(sleep_dis(gen_sleep));  // Simular tiempo de recolección
+    reporte.seg_recoleccion = gen_tiempos.uniforme(1, 4);
+    esperar_simulado(reporte.seg_recoleccion, shared_data->escala_tiempo);  // Simular tiempo de recolección
 
     // Fase 3: Finalización
-    cout << "[EQUIPO " << nombres_equipos[equipo_id] << " - PID: " << pid << "] "
-         << actividades_finalizacion[equipo_id] << endl;
+    reporte.t_finalizacion_ns = ahora_ns();
+    if (salida) publicar_evento(shared_data, equipo_id, pid, FASE_FINALIZACION,
+                                reporte.seg_exploracion + reporte.seg_recoleccion, 0);
 
-    sleep(1);  // Tiempo fijo para finalización
+    reporte.seg_finalizacion = 1;
+    esperar_simulado(reporte.seg_finalizacion, shared_data->escala_tiempo);  // Tiempo fijo para finalización
 
     // Generar resultado aleatorio único para este equipo en este día
-    int porcentaje_exito = generar_resultado(dia, equipo_id);
-    int unidades = calcular_unidades(porcentaje_exito, equipo_id, dia);
+    int unidades = sortear_unidades(shared_data->semilla, 0, dia, equipo_id);
 
     // Escribir resultado final en memoria compartida
-    shared_data->reportes[equipo_id].recursos_recolectados = unidades;
-    shared_data->reportes[equipo_id].estado_equipo = 1;  // Estado: completado
-    shared_data->reportes[equipo_id].pid_equipo = pid;
+    reporte.recursos_recolectados = unidades;
+    reporte.pid_equipo = pid;
+    reporte.t_fin_ns = ahora_ns();
+
+    // Reporte final del equipo (se publica antes de avisar al coordinador, así ya está en el anillo al vaciarlo)
+    if (salida) publicar_evento(shared_data, equipo_id, pid, FASE_COMPLETADO,
+                                reporte.seg_exploracion + reporte.seg_recoleccion + reporte.seg_finalizacion, unidades);
+
+    // Estado: completado (al final y con release: la supervisión lo usa para saber qué equipos reportaron)
+    __atomic_store_n(&reporte.estado_equipo, 1, __ATOMIC_RELEASE);
 
     // Incrementar contador atómicamente (evita condiciones de carrera)
-    __sync_fetch_and_add(&shared_data->equipos_completados, 1);
+    // El equipo que completa el último reporte despierta al coordinador por el eventfd
+    if (__sync_fetch_and_add(&shared_data->equipos_completados, 1) == shared_data->num_equipos - 1) {
+        shared_data->t_ultimo_ns = ahora_ns();
+        uint64_t uno = 1;
+        if (write(shared_data->evento_fd, &uno, sizeof(uno)) == -1) {
+            perror("write eventfd (hijo)");
+        }
+    }
+}
 
-    // Reporte final del equipo
-    cout << "[EQUIPO " << nombres_equipos[equipo_id] << " - PID: " << pid
-         << "] Completo ciclo: " << unidades << " unidades obtenidas" << endl;
+//Afinidad de CPU, Política de Planificación y Nodo NUMA (--cpus, --sched, --numa)
+//En equipos compartidos, el coordinador y los equipos migran entre núcleos y compiten con otros
+//procesos, lo que hace variar la latencia de cada día. Con --cpus el coordinador queda en la primera
+//CPU de la lista y los equipos se reparten round-robin en las demás (con el backend pool se fijan sus
+//trabajadores). --sched fifo|alta sube la prioridad del coordinador, que heredan sus procesos e hilos.
+//--numa ubica la memoria de la simulación en el nodo NUMA de la CPU del coordinador antes de tocarla.
+//Todo se aplica al iniciar coordinador() y se deshace al terminar, así --jitter puede comparar
+//ejecuciones con y sin estos ajustes en un mismo proceso
 
-    // Desconectar de memoria compartida y terminar proceso
-    if (shmdt(shared_data) == -1) {
-        perror("shmdt (hijo)");  // Error al desconectar memoria compartida
+const int PRIORIDAD_FIFO = 10;   //Prioridad de tiempo real de --sched fifo (1..99)
+const int NICE_ALTA = -10;       //Valor nice de --sched alta
+
+//Ajustes vigentes; los fija configurar_afinidad() antes de crear procesos o hilos y luego solo se leen
+vector<int> cpus_afinidad;       //CPUs de --cpus (vacío: sin fijar)
+int nodo_numa = -1;              //Nodo NUMA de la memoria de la simulación (-1: política del sistema)
+
+//Estado del proceso antes de configurar_afinidad(), para restaurarlo
+cpu_set_t afinidad_original;
+int politica_original = SCHED_OTHER;
+struct sched_param parametros_originales;
+int nice_original = 0;
+bool afinidad_configurada = false;
+
+//Lee una lista de CPUs como "0-3,6"; solo acepta CPUs permitidas al proceso
+//Retorna false y deja un mensaje en error si la lista está mal formada o incluye una CPU no permitida
+bool leer_lista_cpus(const string& lista, vector<int>& cpus, string& error) {
+    cpu_set_t permitidas;
+    CPU_ZERO(&permitidas);
+    if (sched_getaffinity(0, sizeof(permitidas), &permitidas) == -1) {
+        error = string("sched_getaffinity: ") + strerror(errno);
+        return false;
     }
-    _exit(0);  // Terminar proceso hijo
+    stringstream flujo(lista);
+    string item;
+    while (getline(flujo, item, ',')) {
+        int desde, hasta;
+        int campos = sscanf(item.c_str(), "%d-%d", &desde, &hasta);
+        if (campos == 1) hasta = desde;
+        if (campos < 1 || desde < 0 || hasta < desde || hasta >= CPU_SETSIZE) {
+            error = "'" + item + "' debe ser CPU o DESDE-HASTA";
+            return false;
+        }
+        for (int cpu = desde; cpu <= hasta; ++cpu) {
+            if (!CPU_ISSET(cpu, &permitidas)) {
+                error = "la CPU " + to_string(cpu) + " no existe o no está permitida para este proceso";
+                return false;
+            }
+            cpus.push_back(cpu);
+        }
+    }
+    if (cpus.empty()) error = "lista de CPUs vacía";
+    return !cpus.empty();
 }
 
-//Función de Evaluación de Supervivencia
-//Evalúa si el grupo sobrevive el día basado en los recursos recolectados
-//totales Recursos totales recolectados por todos los equipos
-//moral_perdida [out] Cantidad de moral perdida (si no se cumplen mínimos)
-//razon_penalizacion [out] Razón de la penalización de moral
-//bool True si se cumplen todos los mínimos, False en caso contrario
+//CPU del coordinador y de cada equipo (o trabajador del pool); -1 si no hay --cpus
+//Con una sola CPU en la lista, todos comparten esa CPU
+int cpu_coordinador() { return cpus_afinidad.empty() ? -1 : cpus_afinidad[0]; }
+int cpu_equipo(int equipo_id) {
+    int n = (int) cpus_afinidad.size();
+    if (n == 0) return -1;
+    return n == 1 ? cpus_afinidad[0] : cpus_afinidad[1 + equipo_id % (n - 1)];
+}
 
-//Sistema de penalizaciones:
-//Agua faltante: -3 puntos por unidad faltante
-//Alimentos faltantes: -2 puntos por unidad faltante  
-//Construcción faltante: -4 puntos por unidad faltante
-//Señales faltantes: -5 puntos por unidad faltante
-bool evaluar_supervivencia(const Recursos& totales, int& moral_perdida, string& razon_penalizacion) {
-    bool sobrevive = true;
-    moral_perdida = 0;
-    razon_penalizacion.clear();  // Limpiar string de razón
-    vector<string> razones;      // Vector para acumular razones de penalización
-
-    // Verificar agua
-    if (totales.agua < MIN_AGUA) {
-        int perdida = (MIN_AGUA - totales.agua) * 3;  // -3 por unidad faltante
-        moral_perdida += perdida; // Acumular penalización
-        razones.push_back("falta de agua");
-        sobrevive = false; // No se cumplen los mínimos
+//Fija el hilo que llama a una CPU (sched_setaffinity sobre el propio hilo); sin efecto con cpu -1
+void fijar_cpu(int cpu) {
+    if (cpu < 0) return;
+    cpu_set_t conjunto;
+    CPU_ZERO(&conjunto);
+    CPU_SET(cpu, &conjunto);
+    if (sched_setaffinity(0, sizeof(conjunto), &conjunto) == -1) perror("sched_setaffinity");
+}
+
+//Nodo NUMA de una CPU según sysfs (directorio nodeN dentro de /sys/devices/system/cpu/cpuM); 0 si no hay NUMA
+int nodo_de_cpu(int cpu) {
+    for (int nodo = 0; nodo < 1024; ++nodo) {
+        string ruta = "/sys/devices/system/cpu/cpu" + to_string(cpu) + "/node" + to_string(nodo);
+        if (access(ruta.c_str(), F_OK) == 0) return nodo;
     }
-    
-    // Verificar alimentos
-    if (totales.alimentos < MIN_ALIMENTOS) {
-        int perdida = (MIN_ALIMENTOS - totales.alimentos) * 2;  // -2 por unidad faltante
-        moral_perdida += perdida; // Acumular penalización
-        razones.push_back("falta de comida");
-        sobrevive = false; // No se cumplen los mínimos
+    return 0;
+}
+
+//Prefiere el nodo nodo_numa para las páginas de [memoria, memoria + tamano); se llama antes de tocarlas
+//(MPOL_PREFERRED: si el nodo se queda sin memoria, se usa otro en lugar de fallar)
+void ubicar_memoria_numa(void* memoria, size_t tamano) {
+    if (nodo_numa < 0) return;
+    uintptr_t pagina = (uintptr_t) sysconf(_SC_PAGESIZE);
+    uintptr_t inicio = (uintptr_t) memoria & ~(pagina - 1);
+    // Máscara de nodos con tantas palabras como pida el nodo (un solo unsigned long no alcanza desde el nodo 64);
+    // el kernel descuenta un bit de maxnode, por eso se pasa uno más
+    const int bits_palabra = sizeof(unsigned long) * 8;
+    vector<unsigned long> mascara(nodo_numa / bits_palabra + 1, 0);
+    mascara[nodo_numa / bits_palabra] = 1UL << (nodo_numa % bits_palabra);
+    if (syscall(SYS_mbind, inicio, (uintptr_t) memoria + tamano - inicio, MPOL_PREFERRED, mascara.data(),
+                mascara.size() * bits_palabra + 1, MPOL_MF_MOVE) == -1) {
+        perror("mbind");
     }
-    
-    // Verificar construcción
-    if (totales.construccion < MIN_CONSTRUCCION) {
-        int perdida = (MIN_CONSTRUCCION - totales.construccion) * 1;  // -4 por unidad faltante
-        moral_perdida += perdida; // Acumular penalización
-        razones.push_back("falta de refugio");
-        sobrevive = false; // No se cumplen los mínimos
+}
+
+//Aplica --cpus, --sched y --numa al coordinador; retorna la descripción de lo aplicado ("" si nada)
+string configurar_afinidad(const OpcionesSimulacion& opciones) {
+    cpus_afinidad = opciones.cpus;
+    nodo_numa = -1;
+    if (opciones.cpus.empty() && opciones.politica.empty() && !opciones.numa) return "";
+
+    sched_getaffinity(0, sizeof(afinidad_original), &afinidad_original);
+    politica_original = sched_getscheduler(0);
+    sched_getparam(0, &parametros_originales);
+    errno = 0;
+    nice_original = getpriority(PRIO_PROCESS, 0);
+    afinidad_configurada = true;
+
+    string descripcion;
+    fijar_cpu(cpu_coordinador());
+    if (!opciones.cpus.empty()) {
+        string lista;
+        for (size_t k = opciones.cpus.size() == 1 ? 0 : 1; k < opciones.cpus.size(); ++k) {
+            lista += (lista.empty() ? "" : ",") + to_string(opciones.cpus[k]);
+        }
+        descripcion = "coordinador en CPU " + to_string(cpu_coordinador()) + ", equipos en CPUs " + lista;
     }
-    
-    // Verificar señales
-    if (totales.senales < MIN_SENALES) {
-        int perdida = (MIN_SENALES - totales.senales) * 2;  // -2 por unidad faltante
-        moral_perdida += perdida; // Acumular penalización
-        razones.push_back("señales insuficientes");
-        sobrevive = false; // No se cumplen los mínimos
-    }
-
-    // Construir mensaje de penalización con formato natural
-    if (!razones.empty()) { // Si hay razones de penalización
-        razon_penalizacion = "por ";
-        for (size_t i = 0; i < razones.size(); ++i) {
-            if (i == 0) {
-                razon_penalizacion += razones[i];
-            } else if (i == razones.size() - 1) {
-                razon_penalizacion += " y " + razones[i];
-            } else {
-                razon_penalizacion += ", " + razones[i];
-            } // Formateo natural con comas y "y", agregando la razon
+    if (opciones.politica == "fifo") {
+        struct sched_param parametros = {};
+        parametros.sched_priority = PRIORIDAD_FIFO;
+        if (sched_setscheduler(0, SCHED_FIFO, &parametros) == -1) {
+            cout << "[!] --sched fifo: " << strerror(errno) << " (requiere CAP_SYS_NICE); se sigue con la política normal" << endl;
+        } else {
+            descripcion += string(descripcion.empty() ? "" : "; ") + "SCHED_FIFO prioridad " + to_string(PRIORIDAD_FIFO);
+        }
+    } else if (opciones.politica == "alta") {
+        if (setpriority(PRIO_PROCESS, 0, NICE_ALTA) == -1) {
+            cout << "[!] --sched alta: " << strerror(errno) << " (requiere CAP_SYS_NICE); se sigue con la prioridad normal" << endl;
+        } else {
+            descripcion += string(descripcion.empty() ? "" : "; ") + "nice " + to_string(NICE_ALTA);
         }
     }
-    
-    return sobrevive; // Retornar si se cumplen todos los mínimos
+    if (opciones.numa) {
+        int cpu = cpu_coordinador() >= 0 ? cpu_coordinador() : sched_getcpu();
+        nodo_numa = nodo_de_cpu(cpu);
+        descripcion += string(descripcion.empty() ? "" : "; ") + "memoria en el nodo NUMA " + to_string(nodo_numa);
+    }
+    return descripcion;
 }
 
-//Función del Coordinador (Proceso Padre)
+//Deshace configurar_afinidad() en el coordinador
+void restaurar_afinidad() {
+    cpus_afinidad.clear();
+    nodo_numa = -1;
+    if (!afinidad_configurada) return;
+    sched_setscheduler(0, politica_original, &parametros_originales);
+    setpriority(PRIO_PROCESS, 0, nice_original);
+    sched_setaffinity(0, sizeof(afinidad_original), &afinidad_original);
+    afinidad_configurada = false;
+}
 
-//Función principal que coordina toda la simulación
-//dias_simulacion Número de días a simular (entre 10 y 30)
+//Función del Equipo (Proceso Hijo)
+//Función ejecutada por cada proceso hijo (equipo de recolección)
+//equipo_id Identificador del equipo (0 a num_equipos-1)
+//shm_id Identificador del segmento de memoria compartida
+//dia Día actual de la simulación
 
-//Crea la memoria compartida, gestiona los procesos hijos y evalúa el progreso
-//Controla las condiciones de victoria/derrota y muestra el estado de la simulación
-void coordinador(int dias_simulacion) {
-    int moral = MORAL_INICIAL;               // Moral inicial del grupo
-    int senales_consecutivas = 0;            // Contador de días consecutivos con señales
-    bool rescate_exitoso = false;            // Bandera de victoria por rescate
+//Cada equipo realiza tres fases: exploración, recolección y finalización
+//Los resultados se escriben en la memoria compartida para que el coordinador los lea
+//El proceso termina después de completar su trabajo y reportar resultados
+void equipo_recoleccion(int equipo_id, int shm_id, int dia) {
+    long long t_entrada_ns = ahora_ns();  // Primer instante del hijo (mide la latencia de fork)
+    fijar_cpu(cpu_equipo(equipo_id));
 
-    // Encabezado de la simulación
-    cout << "=== SISTEMA DE SUPERVIVENCIA ACTIVADO ===" << endl;
-    cout << "Moral inicial: " << MORAL_INICIAL << "/100" << endl;
-    cout << "Días de simulación: " << dias_simulacion << endl << endl;
+    // Conectar a memoria compartida (usando el shmid pasado por el padre)
+    SharedMemoryData* shared_data = (SharedMemoryData*) shmat(shm_id, NULL, 0); // el shared_data es un puntero a la estructura de memoria compartida
+    if (shared_data == (void*) -1) {
+        perror("shmat (hijo)");  // Error al conectar a memoria compartida
+        exit(1); // Terminar proceso hijo en caso de error
+    }
 
-    // Crear segmento de memoria compartida (IPC_PRIVATE evita colisiones de claves)
-    int shm_id = shmget(IPC_PRIVATE, sizeof(SharedMemoryData), IPC_CREAT | 0600);
-    if (shm_id == -1) { //si shm_id es -1, hubo un error
-        perror("shmget (padre)");  // Error al crear memoria compartida
-        exit(1);
+    trabajar_dia(shared_data, equipo_id, dia, t_entrada_ns);
+
+    // Desconectar de memoria compartida y terminar proceso
+    if (shmdt(shared_data) == -1) {
+        perror("shmdt (hijo)");  // Error al desconectar memoria compartida
+    }
+    _exit(0);  // Terminar proceso hijo
+}
+
+//Ciclo de un equipo persistente (proceso o hilo): espera cada día en la barrera y lo trabaja
+//ultimo_dia: último día ya trabajado (un equipo relanzado a mitad de la simulación no repite días)
+void ciclo_persistente(SharedMemoryData* shared_data, int equipo_id, int ultimo_dia) {
+    while (true) {
+        // Esperar (bloqueado en el futex) a que el coordinador libere un día nuevo o pida terminar
+        int dia;
+        while ((dia = __atomic_load_n(&shared_data->ciclo_inicio, __ATOMIC_ACQUIRE)) == ultimo_dia) {
+            futex_esperar(&shared_data->ciclo_inicio, ultimo_dia);
+        }
+        if (dia == CICLO_TERMINAR) break; // Se pidió terminar
+
+        trabajar_dia(shared_data, equipo_id, dia, ahora_ns());
+        ultimo_dia = dia;
     }
+}
 
-    // Conectar el proceso coordinador a la memoria compartida
+//Función del Equipo Persistente (Proceso Hijo de larga vida)
+//El equipo se crea una sola vez, se enlaza una sola vez a la memoria compartida
+//y luego itera sobre los días esperando la barrera de inicio que libera el coordinador
+//equipo_id Identificador del equipo (0 a num_equipos-1)
+//shm_id Identificador del segmento de memoria compartida
+//ultimo_dia Último día ya trabajado (0 al crearse; al relanzarlo, el día anterior si debe rehacer el día en curso)
+void equipo_persistente(int equipo_id, int shm_id, int ultimo_dia) {
+    fijar_cpu(cpu_equipo(equipo_id));
     SharedMemoryData* shared_data = (SharedMemoryData*) shmat(shm_id, NULL, 0);
-    if (shared_data == (void*) -1) { // si shared_data es un puntero inválido, hubo un error
-        perror("shmat (padre)");  // Error al conectar a memoria compartida
-        shmctl(shm_id, IPC_RMID, NULL);  // Intentar limpiar segmento
+    if (shared_data == (void*) -1) {
+        perror("shmat (hijo persistente)");
         exit(1);
     }
 
-    // Inicializar memoria compartida a cero (eliminar basura previa)
-    memset(shared_data, 0, sizeof(SharedMemoryData)); // desde la dirección de shared_data, poner 0s, tamaño de la estructura
+    ciclo_persistente(shared_data, equipo_id, ultimo_dia);
 
-    // Bucle principal de días de simulación
-    for (int dia = 1; dia <= dias_simulacion && moral > 0 && !rescate_exitoso; ++dia) { // Mientras haya moral y no se haya rescatado
-        cout << "=== DÍA " << dia << " DE SUPERVIVENCIA ===" << endl;
-        cout << "Iniciando equipos de recolección..." << endl << endl;
+    if (shmdt(shared_data) == -1) {
+        perror("shmdt (hijo persistente)");
+    }
+    _exit(0);
+}
 
-        // Inicializar datos del día en memoria compartida
-        shared_data->equipos_completados = 0;
-        shared_data->dia_actual = dia;
-        int i; fo(i, 4) {
-            //shared_data->reportes[i] = {i, 0, 0, 0};
-            shared_data->reportes[i].id_equipo = i;
-            shared_data->reportes[i].recursos_recolectados = 0;
-            shared_data->reportes[i].estado_equipo = 0;  // Estado: trabajando
-            shared_data->reportes[i].pid_equipo = 0;
-        }
-
-        // Crear procesos hijos (equipos de recolección)
-        vector<pid_t> pids(4, -1);  // Vector para almacenar PIDs de los hijos
-        fo(i, 4) {
-            pid_t pid = fork();  // Crear proceso hijo
-            
-            if (pid < 0) {
-                // Error al crear proceso hijo
-                perror("fork (padre)");
-                
-                // Esperar a los hijos ya creados antes de salir
-                int j; fo (j, i) {
-                    if (pids[j] > 0) waitpid(pids[j], NULL, 0);
-                }
-                
-                // Limpiar memoria compartida
-                shmdt(shared_data);
-                shmctl(shm_id, IPC_RMID, NULL);
-                exit(1);
-            } else if (pid == 0) {
-                // Código ejecutado por el proceso hijo
-                equipo_recoleccion(i, shm_id, dia);
-                // Nunca llega aquí (el hijo termina en equipo_recoleccion)
-            } else {
-                // Código ejecutado por el proceso padre
-                pids[i] = pid;  // Almacenar PID del hijo
-            }
-        }
+//Pool de Tareas con Robo de Trabajo
+//Cada trabajador tiene su propia cola: toma sus tareas por el final (LIFO, datos aún en caché) y,
+//si se queda sin trabajo, roba por el frente de las colas de los demás. Permite correr muchos
+//equipos o simulaciones por núcleo sin crear un hilo por tarea
+struct PoolRobo {
+    typedef function<void(int)> Tarea;  //Recibe el índice del trabajador que la ejecuta
 
-        // Esperar a que los 4 equipos completen su trabajo (polling responsivo)
-        while (shared_data->equipos_completados < 4) {
-            usleep(100000);  // Esperar 100ms (más responsivo que sleep(1))
-        }
+    //Cola de un trabajador (un mutex por cola: los robos no compiten con las demás colas)
+    struct ColaTrabajador {
+        mutex cerrojo;
+        deque<Tarea> tareas;
+    };
 
-        // Recoger resultados de la memoria compartida
-        Recursos recursos_dia = {0, 0, 0, 0};
-        recursos_dia.agua = shared_data->reportes[0].recursos_recolectados;
-        recursos_dia.alimentos = shared_data->reportes[1].recursos_recolectados;
-        recursos_dia.construccion = shared_data->reportes[2].recursos_recolectados;
-        recursos_dia.senales = shared_data->reportes[3].recursos_recolectados;
-
-        // Esperar terminación de todos los procesos hijos (limpieza)
-        fo (i, 4) {
-            if (pids[i] > 0) waitpid(pids[i], NULL, 0);
-        }
-
-        // Mostrar reportes finales del día
-        cout << "\nREPORTES FINALES:" << endl;
-        cout << "[#] Equipo Agua (PID: " << shared_data->reportes[0].pid_equipo << "): "
-             << recursos_dia.agua << " unidades obtenidas" << endl;
-        cout << "[#] Equipo Alimentos (PID: " << shared_data->reportes[1].pid_equipo << "): "
-             << recursos_dia.alimentos << " unidades obtenidas" << endl;
-        cout << "[#] Equipo Construcción (PID: " << shared_data->reportes[2].pid_equipo << "): "
-             << recursos_dia.construccion << " unidades obtenidas" << endl;
-        cout << "[#] Equipo Señales (PID: " << shared_data->reportes[3].pid_equipo << "): "
-             << recursos_dia.senales << " unidades obtenidas" << endl;
-
-        // Mostrar resultados vs requisitos mínimos
-        cout << "\nRESULTADOS DEL DÍA:" << endl;
-        cout << "[i] Agua recolectada: " << recursos_dia.agua << "/" << MIN_AGUA << " ("
-             << (recursos_dia.agua >= MIN_AGUA ? "SUFICIENTE" : "INSUFICIENTE") << ")" << endl;
-        cout << "[i] Alimentos obtenidos: " << recursos_dia.alimentos << "/" << MIN_ALIMENTOS << " ("
-             << (recursos_dia.alimentos >= MIN_ALIMENTOS ? "SUFICIENTE" : "INSUFICIENTE") << ")" << endl;
-        cout << "[i] Materiales de construcción: " << recursos_dia.construccion << "/" << MIN_CONSTRUCCION << " ("
-             << (recursos_dia.construccion >= MIN_CONSTRUCCION ? "SUFICIENTE" : "INSUFICIENTE") << ")" << endl;
-        cout << "[i] Señales mantenidas: " << recursos_dia.senales << "/" << MIN_SENALES << " ("
-             << (recursos_dia.senales >= MIN_SENALES ? "SUFICIENTE" : "INSUFICIENTE") << ")" << endl;
-
-        // Evaluar supervivencia y calcular penalizaciones
-        int moral_perdida;
-        string razon_penalizacion;
-        bool dia_sobrevivido = evaluar_supervivencia(recursos_dia, moral_perdida, razon_penalizacion);
-
-        // Aplicar penalización a la moral
-        moral -= moral_perdida;
-        if (moral < 0) moral = 0;  // La moral nunca puede ser negativa
-
-        // Actualizar contador de señales consecutivas
-        if (recursos_dia.senales >= MIN_SENALES) {
-            ++senales_consecutivas;
-            cout << "[✓] Señales activas: Día " << senales_consecutivas << " consecutivo" << endl;
-        } else {
-            senales_consecutivas = 0;  // Reiniciar contador si no hay señales suficientes
-            cout << "[✖] Señales insuficientes, contador reiniciado" << endl;
-        }
+    vector<unique_ptr<ColaTrabajador>> colas;
+    vector<thread> hilos;
+    mutex cerrojo_espera;                 //Protege las esperas en las variables de condición
+    condition_variable hay_trabajo, sin_pendientes;
+    atomic<long long> en_cola, pendientes;  //Tareas sin tomar / tareas sin terminar
+    atomic<unsigned> siguiente_cola;        //Reparto inicial round-robin de enviar()
+    bool terminar;
 
-        // Mostrar estado y moral actual
-        cout << "\nEstado: " << (dia_sobrevivido ? "DÍA SUPERADO" : "SUPERVIVENCIA CRÍTICA") << endl;
-        cout << "Moral del grupo: " << moral << "/100";
-        if (moral_perdida > 0) {
-            cout << " (-" << moral_perdida << " " << razon_penalizacion << ")";
-        } else {
-            cout << " (sin cambio)";
-        }
-        cout << endl;
+    explicit PoolRobo(int num_trabajadores) : en_cola(0), pendientes(0), siguiente_cola(0), terminar(false) {
+        for (int w = 0; w < num_trabajadores; ++w) colas.emplace_back(new ColaTrabajador());
+        for (int w = 0; w < num_trabajadores; ++w) hilos.emplace_back([this, w]() { trabajar(w); });
+    }
 
-        // Verificar condiciones de victoria/derrota
-        if (senales_consecutivas >= DIAS_RESCATE) {
-            // Victoria por rescate exitoso (ej: 10 días consecutivos con señales)
-            cout << "\n██▓▒░ ¡RESCATE EXITOSO! ░▒▓██" << endl;
-            cout << "Han mantenido señales activas por " << senales_consecutivas << " días consecutivos" << endl;
-            rescate_exitoso = true;
-            break;
+    ~PoolRobo() {
+        {
+            lock_guard<mutex> guardia(cerrojo_espera);
+            terminar = true;
         }
-        
-        if (moral <= 0) {
-            // Derrota por moral agotada
-            cout << "\n██▓▒░ FRACASO - MORAL AGOTADA ░▒▓██" << endl;
-            cout << "El grupo ha perdido la esperanza después de " << dia << " días" << endl;
-            break;
+        hay_trabajo.notify_all();
+        for (thread& t : hilos) t.join();
+    }
+
+    int trabajadores() const { return (int) colas.size(); }
+
+    //Encola una tarea (se reparte round-robin; los trabajadores ociosos la pueden robar)
+    void enviar(Tarea tarea) {
+        ++pendientes;
+        ColaTrabajador& cola = *colas[siguiente_cola++ % colas.size()];
+        {
+            lock_guard<mutex> guardia(cola.cerrojo);
+            cola.tareas.push_back(move(tarea));
         }
-        
-        if (dia == dias_simulacion && !rescate_exitoso) {
-            // Fin por límite de tiempo sin victoria/derrota
-            cout << "\n██▓▒░ LÍMITE DE TIEMPO ALCANZADO ░▒▓██" << endl;
-            cout << "Sobrevivieron " << dias_simulacion << " días con moral " << moral << "/100" << endl;
-            cout << "Señales activas consecutivas: " << senales_consecutivas << "/" << DIAS_RESCATE << endl;
+        {
+            lock_guard<mutex> guardia(cerrojo_espera);  // Evita perder el aviso a un trabajador que se duerme
+            ++en_cola;
         }
+        hay_trabajo.notify_one();
+    }
 
-        cout << "\n----------------------------------------\n" << endl;
-        sleep(1);  // Pausa breve entre días para legibilidad
+    //Bloquea hasta que todas las tareas enviadas hayan terminado
+    void esperar() {
+        unique_lock<mutex> guardia(cerrojo_espera);
+        sin_pendientes.wait(guardia, [this]() { return pendientes.load() == 0; });
     }
 
-    // Mensaje final de victoria (si aplica)
-    if (rescate_exitoso) {
-        cout << "\n██▓▒░ FELICIDADES - MISIÓN CUMPLIDA ░▒▓██" << endl;
-        cout << "Todos los sobrevivientes han sido rescatados exitosamente" << endl;
+    //Toma una tarea de la cola propia (final) o roba una de otra cola (frente)
+    bool tomar(int w, Tarea& tarea) {
+        int n = (int) colas.size();
+        for (int k = 0; k < n; ++k) {
+            ColaTrabajador& cola = *colas[(w + k) % n];
+            lock_guard<mutex> guardia(cola.cerrojo);
+            if (cola.tareas.empty()) continue;
+            if (k == 0) {
+                tarea = move(cola.tareas.back());
+                cola.tareas.pop_back();
+            } else {
+                tarea = move(cola.tareas.front());
+                cola.tareas.pop_front();
+            }
+            --en_cola;
+            return true;
+        }
+        return false;
     }
 
-    // Limpieza final: desconectar y eliminar memoria compartida
-    if (shmdt(shared_data) == -1) {
-        perror("shmdt (padre)");  // Error al desconectar memoria compartida
+    //Bucle de cada trabajador: ejecuta tareas mientras haya y duerme cuando no quedan
+    void trabajar(int w) {
+        Tarea tarea;
+        while (true) {
+            if (tomar(w, tarea)) {
+                tarea(w);
+                tarea = nullptr;
+                if (--pendientes == 0) {
+                    { lock_guard<mutex> guardia(cerrojo_espera); }
+                    sin_pendientes.notify_all();
+                }
+                continue;
+            }
+            unique_lock<mutex> guardia(cerrojo_espera);
+            hay_trabajo.wait(guardia, [this]() { return terminar || en_cola.load() > 0; });
+            if (terminar && en_cola.load() == 0) return;
+        }
     }
-    
-    if (shmctl(shm_id, IPC_RMID, NULL) == -1) {
-        perror("shmctl(IPC_RMID)");  // Error al eliminar segmento
+};
+
+//Espera a que todos los equipos reporten el día
+//Modo por defecto: bloqueo en epoll sobre el eventfd que señaliza el último equipo (sin latencia de sondeo)
+//Modo polling: sondeo original cada 100ms del contador equipos_completados
+void esperar_equipos(SharedMemoryData* shared_data, int epoll_fd, bool polling) {
+    if (polling) {
+        while (__atomic_load_n(&shared_data->equipos_completados, __ATOMIC_ACQUIRE) < shared_data->num_equipos) {
+            usleep(100000);  // Esperar 100ms (más responsivo que sleep(1))
+        }
+        return;
+    }
+    while (__atomic_load_n(&shared_data->equipos_completados, __ATOMIC_ACQUIRE) < shared_data->num_equipos) {
+        struct epoll_event ev;
+        int n = epoll_wait(epoll_fd, &ev, 1, -1);
+        if (n == -1) {
+            if (errno == EINTR) continue; // Interrumpido por una señal: volver a esperar
+            perror("epoll_wait (padre)");
+            exit(1);
+        }
+        uint64_t cuenta;
+        if (read(shared_data->evento_fd, &cuenta, sizeof(cuenta)) == -1 && errno != EAGAIN) {
+            perror("read eventfd (padre)");
+        }
     }
 }
 
-//Función principal que gestiona los argumentos y inicia la simulación
-//argc Cantidad de argumentos
+//Backends de Ejecución de Equipos
+//El coordinador no sabe cómo se ejecutan los equipos: pide la memoria del día, lanza el día y lo
+//recoge a través de esta interfaz. Todos los backends corren trabajar_dia() sobre la misma
+//estructura SharedMemoryData (barrera futex, eventfd de término, reportes y anillos de eventos)
+struct BackendEquipos {
+    virtual ~BackendEquipos() {}
+    //Descripción para el encabezado y las métricas ("fork por día", "hilos persistentes", ...)
+    virtual string descripcion() const = 0;
+    //Reserva la memoria de la simulación (a cero); termina el programa si no se puede
+    virtual SharedMemoryData* crear_memoria(size_t tamano) = 0;
+    //Prepara los equipos antes del primer día (crea los persistentes); epoll_fd es el epoll del
+    //coordinador, donde el backend puede registrar sus propios descriptores
+    virtual void iniciar(SharedMemoryData* shared_data, int epoll_fd) = 0;
+    //Pone a trabajar a todos los equipos en el día dia (anota t_lanzamiento_ns de cada uno)
+    virtual void lanzar_dia(SharedMemoryData* shared_data, int dia) = 0;
+    //Espera a que todos los equipos del día reporten; limite_ns es el plazo absoluto del día (0: sin plazo)
+    //Por defecto no hay supervisión: los hilos no pueden morir ni terminarse por separado
+    virtual void esperar_dia(SharedMemoryData* shared_data, int epoll_fd, bool polling, int, long long) {
+        esperar_equipos(shared_data, epoll_fd, polling);
+    }
+    //Libera los recursos del día una vez que todos los equipos reportaron (waitpid, join)
+    virtual void recoger_dia(SharedMemoryData* shared_data) = 0;
+    //Termina los equipos y libera la memoria
+    virtual void terminar(SharedMemoryData* shared_data) = 0;
+
+    int relanzados = 0;  //Equipos relanzados por la supervisión
+    int fallidos = 0;    //Equipos-día contados como fallidos (murieron dos veces o superaron el plazo)
+};
+
+//Backend de procesos (original): fork por día o equipos persistentes, sobre memoria compartida SysV
+//Supervisa a los hijos con pidfd en el epoll del coordinador: un equipo que muere sin reportar se
+//relanza una vez en el día y, si vuelve a fallar o supera el plazo del día, se cuenta como fallido
+struct BackendProcesos : BackendEquipos {
+    bool persistentes;
+    int shm_id = -1;
+    int epoll_fd = -1;    // Epoll del coordinador (ahí se registran los pidfd)
+    vector<pid_t> pids;   // PIDs de los hijos
+    vector<int> pidfds;   // pidfd de cada hijo (-1: sin supervisar)
+    vector<int> reintentos;  // Relanzamientos de cada equipo en el día actual
+
+    explicit BackendProcesos(bool equipos_persistentes) : persistentes(equipos_persistentes) {}
+
+    string descripcion() const override { return persistentes ? "persistentes" : "fork por día"; }
+
+    SharedMemoryData* crear_memoria(size_t tamano) override {
+        // Crear segmento de memoria compartida (IPC_PRIVATE evita colisiones de claves), dimensionado según los equipos
+        shm_id = shmget(IPC_PRIVATE, tamano, IPC_CREAT | 0600);
+        if (shm_id == -1) { //si shm_id es -1, hubo un error
+            perror("shmget (padre)");  // Error al crear memoria compartida
+            exit(1);
+        }
+
+        // Conectar el proceso coordinador a la memoria compartida
+        SharedMemoryData* shared_data = (SharedMemoryData*) shmat(shm_id, NULL, 0);
+        if (shared_data == (void*) -1) { // si shared_data es un puntero inválido, hubo un error
+            perror("shmat (padre)");  // Error al conectar a memoria compartida
+            shmctl(shm_id, IPC_RMID, NULL);  // Intentar limpiar segmento
+            exit(1);
+        }
+
+        // Inicializar memoria compartida a cero (eliminar basura previa), ya en el nodo NUMA elegido
+        ubicar_memoria_numa(shared_data, tamano);
+        memset(shared_data, 0, tamano); // desde la dirección de shared_data, poner 0s, tamaño del segmento
+        return shared_data;
+    }
+
+    //Error al crear un hijo: esperar a los ya creados, limpiar la memoria compartida y salir
+    void abortar(SharedMemoryData* shared_data) {
+        perror("fork (padre)");
+        if (persistentes) liberar_ciclo(shared_data, CICLO_TERMINAR);  // Pedir término a los persistentes
+        for (pid_t pid : pids) {
+            if (pid > 0) waitpid(pid, NULL, 0);
+        }
+        shmdt(shared_data);
+        shmctl(shm_id, IPC_RMID, NULL);
+        exit(1);
+    }
+
+    //Registra el pidfd del hijo del equipo i en el epoll (si el kernel no tiene pidfd, solo rige el plazo)
+    void vigilar(int i) {
+        pidfds[i] = (int) syscall(SYS_pidfd_open, pids[i], 0);
+        if (pidfds[i] == -1) return;
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.u64 = (uint64_t) i;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pidfds[i], &ev) == -1) {
+            perror("epoll_ctl pidfd (padre)");
+            close(pidfds[i]);
+            pidfds[i] = -1;
+        }
+    }
+
+    //Quita el pidfd del epoll antes de cerrarlo (los hijos heredan copias que lo mantendrían registrado)
+    void dejar_de_vigilar(int i) {
+        if (pidfds[i] == -1) return;
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, pidfds[i], NULL);
+        close(pidfds[i]);
+        pidfds[i] = -1;
+    }
+
+    //Crea el proceso del equipo i; un persistente trabaja los días posteriores a ultimo_dia
+    void crear_hijo(SharedMemoryData* shared_data, int i, int dia, int ultimo_dia) {
+        pid_t pid = fork();  // Crear proceso hijo
+        if (pid < 0) {
+            // Error al crear proceso hijo
+            abortar(shared_data);
+        } else if (pid == 0) {
+            // Código ejecutado por el proceso hijo (nunca retorna: termina en _exit)
+            if (persistentes) equipo_persistente(i, shm_id, ultimo_dia);
+            else equipo_recoleccion(i, shm_id, dia);
+        }
+        // Código ejecutado por el proceso padre
+        pids[i] = pid;  // Almacenar PID del hijo
+        vigilar(i);
+    }
+
+    void iniciar(SharedMemoryData* shared_data, int epoll_coordinador) override {
+        epoll_fd = epoll_coordinador;
+        pids.assign(shared_data->num_equipos, -1);
+        pidfds.assign(shared_data->num_equipos, -1);
+        reintentos.assign(shared_data->num_equipos, 0);
+        if (!persistentes) return;
+        // Modo persistente: crear los equipos una sola vez antes del primer día
+        int i; fo(i, shared_data->num_equipos) crear_hijo(shared_data, i, 0, 0);
+    }
+
+    void lanzar_dia(SharedMemoryData* shared_data, int dia) override {
+        int i;
+        fill(reintentos.begin(), reintentos.end(), 0);
+        ReporteEquipo* reportes = reportes_dia(shared_data, dia);
+        if (persistentes) {
+            // Liberar la barrera de inicio: los equipos persistentes esperan este valor
+            long long t_lanzamiento = ahora_ns();
+            fo(i, shared_data->num_equipos) reportes[i].t_lanzamiento_ns = t_lanzamiento;
+            liberar_ciclo(shared_data, dia);
+            return;
+        }
+        fo(i, shared_data->num_equipos) {
+            // Crear procesos hijos (equipos de recolección)
+            reportes[i].t_lanzamiento_ns = ahora_ns();
+            crear_hijo(shared_data, i, dia, 0);
+        }
+    }
+
+    //Da por fallido al equipo i en el día: 0 unidades, instantes acotados al ahora y cuenta como completado
+    void marcar_fallido(SharedMemoryData* shared_data, int i, int dia) {
+        ReporteEquipo& r = reportes_dia(shared_data, dia)[i];
+        long long ahora = ahora_ns();
+        long long* instantes[] = {&r.t_entrada_ns, &r.t_inicio_ns, &r.t_recoleccion_ns, &r.t_finalizacion_ns};
+        long long previo = r.t_lanzamiento_ns;
+        for (long long* t : instantes) {
+            *t = min(max(*t, previo), ahora);
+            previo = *t;
+        }
+        r.t_fin_ns = ahora;
+        r.recursos_recolectados = 0;
+        __atomic_store_n(&r.estado_equipo, 2, __ATOMIC_RELEASE);  // Estado: fallido
+        ++fallidos;
+        // Cuenta en equipos_completados, así el último equipo sano sigue despertando al coordinador
+        if (__sync_fetch_and_add(&shared_data->equipos_completados, 1) == shared_data->num_equipos - 1) {
+            shared_data->t_ultimo_ns = ahora;
+        }
+    }
+
+    //El pidfd del equipo i indicó que su proceso terminó: recogerlo y, si no reportó, relanzarlo o darlo por fallido
+    void atender_salida(SharedMemoryData* shared_data, int i, int dia) {
+        int estado_hijo = 0;
+        pid_t pid = pids[i];
+        long long t_recoger = ahora_ns();
+        waitpid(pid, &estado_hijo, 0);
+        registrar_muestra(shared_data->estadisticas.tramos[TRAMO_RECOGER], ahora_ns() - t_recoger);
+        dejar_de_vigilar(i);
+        pids[i] = -1;
+
+        bool reporto = __atomic_load_n(&reportes_dia(shared_data, dia)[i].estado_equipo, __ATOMIC_ACQUIRE) != 0;
+        if (reporto && !persistentes) return;  // Salida normal del hijo del día
+
+        bool relanzar_hoy = !reporto && reintentos[i] < MAX_REINTENTOS_DIA;
+        if (!shared_data->silencioso) {
+            cout << "[!] Equipo " << campamento.equipos[i].nombre << " (PID: " << pid << ") terminó "
+                 << (reporto ? "después de reportar" : "sin reportar");
+            if (WIFSIGNALED(estado_hijo)) cout << " (señal " << WTERMSIG(estado_hijo) << ")";
+            else cout << " (código " << WEXITSTATUS(estado_hijo) << ")";
+            cout << (relanzar_hoy ? ": se relanza" : reporto ? ": se relanza para el día siguiente"
+                                                            : ": se cuenta como fallido (0 unidades)") << endl;
+        }
+        if (relanzar_hoy) {
+            ++reintentos[i];
+            ++relanzados;
+            descartar_eventos(shared_data, i, pid);  // El relanzado vuelve a publicar las fases del día
+            crear_hijo(shared_data, i, dia, dia - 1);  // Persistente: trabaja el día en curso
+            return;
+        }
+        if (!reporto) marcar_fallido(shared_data, i, dia);
+        if (persistentes) {
+            if (reporto) ++relanzados;
+            crear_hijo(shared_data, i, dia, dia);  // Persistente: espera el día siguiente
+        }
+    }
+
+    //Espera con supervisión: termina cuando todos los equipos del día reportaron o fueron dados por fallidos
+    void esperar_dia(SharedMemoryData* shared_data, int epoll_coordinador, bool polling, int dia,
+                     long long limite_ns) override {
+        const ReporteEquipo* reportes = reportes_dia(shared_data, dia);
+        int n = shared_data->num_equipos;
+        struct epoll_event eventos[16];
+        while (true) {
+            int pendientes = 0;
+            int i; fo(i, n) pendientes += __atomic_load_n(&reportes[i].estado_equipo, __ATOMIC_ACQUIRE) == 0;
+            if (pendientes == 0) return;
+
+            // Plazo del día vencido: terminar a los equipos que no reportaron y darlos por fallidos
+            long long restante_ns = limite_ns > 0 ? limite_ns - ahora_ns() : -1;
+            if (limite_ns > 0 && restante_ns <= 0) {
+                fo(i, n) {
+                    if (__atomic_load_n(&reportes[i].estado_equipo, __ATOMIC_ACQUIRE) != 0) continue;
+                    pid_t pid = pids[i];
+                    if (!shared_data->silencioso) {
+                        cout << "[!] Equipo " << campamento.equipos[i].nombre << " (PID: " << pid
+                             << ") superó el plazo del día: se termina y se cuenta como fallido (0 unidades)" << endl;
+                    }
+                    if (pid > 0) {
+                        kill(pid, SIGKILL);
+                        waitpid(pid, NULL, 0);
+                        dejar_de_vigilar(i);
+                        pids[i] = -1;
+                    }
+                    marcar_fallido(shared_data, i, dia);
+                    if (persistentes) crear_hijo(shared_data, i, dia, dia);  // Reemplazo para el día siguiente
+                }
+                return;
+            }
+
+            // Esperar reportes (eventfd), salidas de hijos (pidfd) o el plazo
+            int espera_ms = restante_ns < 0 ? -1 : (int) min<long long>(restante_ns / 1000000 + 1, INT_MAX);
+            if (polling) {
+                usleep(100000);  // Modo sondeo: revisar cada 100ms
+                espera_ms = 0;
+            }
+            int listos = epoll_wait(epoll_coordinador, eventos, 16, espera_ms);
+            if (listos == -1) {
+                if (errno == EINTR) continue; // Interrumpido por una señal: volver a esperar
+                perror("epoll_wait (padre)");
+                exit(1);
+            }
+            for (int k = 0; k < listos; ++k) {
+                if (eventos[k].data.u64 == ETIQUETA_EVENTFD) {
+                    uint64_t cuenta;
+                    if (read(shared_data->evento_fd, &cuenta, sizeof(cuenta)) == -1 && errno != EAGAIN) {
+                        perror("read eventfd (padre)");
+                    }
+                } else {
+                    int equipo = (int) eventos[k].data.u64;
+                    if (pids[equipo] > 0) atender_salida(shared_data, equipo, dia);
+                }
+            }
+        }
+    }
+
+    void recoger_dia(SharedMemoryData* shared_data) override {
+        if (persistentes) return;
+        // Esperar terminación de todos los procesos hijos (limpieza, solo en modo fork por día)
+        // Un hijo ya recogido por atender_salida (pids[i] == -1) no aporta muestra al histograma
+        int i; fo (i, shared_data->num_equipos) {
+            if (pids[i] > 0) {
+                long long t_recoger = ahora_ns();
+                waitpid(pids[i], NULL, 0);
+                registrar_muestra(shared_data->estadisticas.tramos[TRAMO_RECOGER], ahora_ns() - t_recoger);
+            }
+            dejar_de_vigilar(i);
+            pids[i] = -1;
+        }
+    }
+
+    void terminar(SharedMemoryData* shared_data) override {
+        // Terminar equipos persistentes: liberar la barrera con la bandera de término y recogerlos
+        if (persistentes) {
+            liberar_ciclo(shared_data, CICLO_TERMINAR);
+            int i; fo (i, shared_data->num_equipos) {
+                if (pids[i] > 0) waitpid(pids[i], NULL, 0);
+                dejar_de_vigilar(i);
+            }
+        }
+
+        // Limpieza final: desconectar y eliminar memoria compartida
+        if (shmdt(shared_data) == -1) {
+            perror("shmdt (padre)");  // Error al desconectar memoria compartida
+        }
+
+        if (shmctl(shm_id, IPC_RMID, NULL) == -1) {
+            perror("shmctl(IPC_RMID)");  // Error al eliminar segmento
+        }
+    }
+};
+
+//Memoria común de los backends de hilos: heap alineado a línea de caché (no hace falta SysV)
+SharedMemoryData* crear_memoria_local(size_t tamano) {
+    void* memoria = aligned_alloc(64, (tamano + 63) / 64 * 64);
+    if (memoria == NULL) {
+        perror("aligned_alloc");
+        exit(1);
+    }
+    ubicar_memoria_numa(memoria, tamano);
+    memset(memoria, 0, tamano);
+    return (SharedMemoryData*) memoria;
+}
+
+//Backend de hilos: un std::thread por equipo y día (o persistente con la misma barrera futex)
+struct BackendHilos : BackendEquipos {
+    bool persistentes;
+    vector<thread> hilos;
+
+    explicit BackendHilos(bool equipos_persistentes) : persistentes(equipos_persistentes) {}
+
+    string descripcion() const override { return persistentes ? "hilos persistentes" : "hilos por día"; }
+
+    SharedMemoryData* crear_memoria(size_t tamano) override { return crear_memoria_local(tamano); }
+
+    void iniciar(SharedMemoryData* shared_data, int) override {
+        if (!persistentes) return;
+        for (int i = 0; i < shared_data->num_equipos; ++i) {
+            hilos.emplace_back([shared_data, i]() {
+                fijar_cpu(cpu_equipo(i));
+                ciclo_persistente(shared_data, i, 0);
+            });
+        }
+    }
+
+    void lanzar_dia(SharedMemoryData* shared_data, int dia) override {
+        int i;
+        if (persistentes) {
+            long long t_lanzamiento = ahora_ns();
+            ReporteEquipo* reportes = reportes_dia(shared_data, dia);
+            fo(i, shared_data->num_equipos) reportes[i].t_lanzamiento_ns = t_lanzamiento;
+            liberar_ciclo(shared_data, dia);
+            return;
+        }
+        fo(i, shared_data->num_equipos) {
+            reportes_dia(shared_data, dia)[i].t_lanzamiento_ns = ahora_ns();
+            hilos.emplace_back([shared_data, i, dia]() {
+                fijar_cpu(cpu_equipo(i));
+                trabajar_dia(shared_data, i, dia, ahora_ns());
+            });
+        }
+    }
+
+    void recoger_dia(SharedMemoryData* shared_data) override {
+        if (persistentes) return;
+        for (thread& t : hilos) {
+            long long t_recoger = ahora_ns();
+            t.join();
+            registrar_muestra(shared_data->estadisticas.tramos[TRAMO_RECOGER], ahora_ns() - t_recoger);
+        }
+        hilos.clear();
+    }
+
+    void terminar(SharedMemoryData* shared_data) override {
+        if (persistentes) {
+            liberar_ciclo(shared_data, CICLO_TERMINAR);
+            for (thread& t : hilos) t.join();
+        }
+        free(shared_data);
+    }
+};
+
+//Backend de pool con robo de trabajo: cada equipo del día es una tarea; pocos hilos para muchos equipos
+//Las pausas del reloj virtual ocupan al trabajador, por lo que conviene usarlo con --time-scale 0
+struct BackendPool : BackendEquipos {
+    PoolRobo pool;
+
+    //Con --cpus se fijan los trabajadores (no los equipos, que pasan de un trabajador a otro)
+    explicit BackendPool(int trabajadores) : pool(trabajadores) {
+        for (int w = 0; w < trabajadores && !cpus_afinidad.empty(); ++w) {
+            cpu_set_t conjunto;
+            CPU_ZERO(&conjunto);
+            CPU_SET(cpu_equipo(w), &conjunto);
+            int error = pthread_setaffinity_np(pool.hilos[w].native_handle(), sizeof(conjunto), &conjunto);
+            if (error != 0) cout << "[!] pthread_setaffinity_np: " << strerror(error) << endl;
+        }
+    }
+
+    string descripcion() const override {
+        return "pool con robo de trabajo (" + to_string(pool.trabajadores()) + " hilos)";
+    }
+
+    SharedMemoryData* crear_memoria(size_t tamano) override { return crear_memoria_local(tamano); }
+
+    void iniciar(SharedMemoryData*, int) override {}
+
+    void lanzar_dia(SharedMemoryData* shared_data, int dia) override {
+        long long t_lanzamiento = ahora_ns();
+        for (int i = 0; i < shared_data->num_equipos; ++i) {
+            reportes_dia(shared_data, dia)[i].t_lanzamiento_ns = t_lanzamiento;
+            pool.enviar([shared_data, i, dia](int) { trabajar_dia(shared_data, i, dia, ahora_ns()); });
+        }
+    }
+
+    void recoger_dia(SharedMemoryData*) override { pool.esperar(); }
+
+    void terminar(SharedMemoryData* shared_data) override { free(shared_data); }
+};
+
+//Crea el backend pedido con --backend (procesos, hilos o pool)
+unique_ptr<BackendEquipos> crear_backend(const OpcionesSimulacion& opciones) {
+    if (opciones.backend == "hilos") return unique_ptr<BackendEquipos>(new BackendHilos(opciones.equipos_persistentes));
+    if (opciones.backend == "pool") {
+        int trabajadores = opciones.hilos > 0 ? opciones.hilos : (int) max(1u, thread::hardware_concurrency());
+        return unique_ptr<BackendEquipos>(new BackendPool(trabajadores));
+    }
+    return unique_ptr<BackendEquipos>(new BackendProcesos(opciones.equipos_persistentes));
+}
+
+//Función de Evaluación de Supervivencia
+
+//Razones de penalización como bits (bit k: faltó el recurso k; se traducen a texto solo al mostrar el día)
+enum RazonPenalizacion {
+    FALTA_AGUA = 1 << RECURSO_AGUA,
+    FALTA_COMIDA = 1 << RECURSO_ALIMENTOS,
+    FALTA_REFUGIO = 1 << RECURSO_CONSTRUCCION,
+    FALTA_SENALES = 1 << RECURSO_SENALES
+};
+
+//Resultado compacto de evaluar un día: sin cadenas ni memoria dinámica
+struct EvaluacionDia {
+    int moral_perdida;  //Cantidad de moral perdida (0 si se cumplen los mínimos)
+    unsigned razones;   //Máscara de RazonPenalizacion (0: se cumplen todos los mínimos)
+};
+
+//Evalúa si el grupo sobrevive el día basado en los recursos recolectados
+//totales Recursos totales recolectados por todos los equipos
+//reglas Mínimos y penalizaciones por unidad faltante de cada recurso
+//EvaluacionDia Moral perdida y máscara de razones; el día se supera si razones == 0
+//Camino caliente: no reserva memoria ni construye texto (ver formatear_razones)
+
+//Sistema de penalizaciones por defecto:
+//Agua faltante: -3 puntos por unidad faltante
+//Alimentos faltantes: -2 puntos por unidad faltante  
+//Construcción faltante: -1 punto por unidad faltante
+//Señales faltantes: -2 puntos por unidad faltante
+inline EvaluacionDia evaluar_supervivencia(const Recursos& totales, const ReglasSupervivencia& reglas) {
+    EvaluacionDia ev = {0, 0};
+    for (int k = 0; k < NUM_RECURSOS; ++k) {
+        int faltante = reglas.minimo[k] - totales.cantidad[k];
+        if (faltante > 0) {
+            ev.moral_perdida += faltante * reglas.penalizacion[k]; // Acumular penalización
+            ev.razones |= 1u << k;                                  // No se cumple el mínimo del recurso k
+        }
+    }
+    return ev;
+}
+
+//Construye el mensaje de penalización con formato natural ("por falta de agua y falta de comida")
+//Solo se llama cuando hay salida por consola habilitada
+string formatear_razones(unsigned razones) {
+    int total = __builtin_popcount(razones);
+    if (total == 0) return "";
+
+    string razon_penalizacion = "por ";
+    int escritas = 0;
+    for (int i = 0; i < NUM_RECURSOS; ++i) {
+        if (!(razones & (1u << i))) continue;
+        const string& razon = campamento.recursos[i].razon;
+        if (escritas == 0) {
+            razon_penalizacion += razon;
+        } else if (escritas == total - 1) {
+            razon_penalizacion += " y " + razon;
+        } else {
+            razon_penalizacion += ", " + razon;
+        } // Formateo natural con comas y "y", agregando la razon
+        ++escritas;
+    }
+    return razon_penalizacion;
+}
+
+//Escribe todo el buffer en el descriptor (reintentando escrituras parciales o interrumpidas)
+//bool false si la escritura falló (el error ya se informó con perror)
+bool escribir_todo(int fd, const void* datos, size_t tamano) {
+    size_t escrito = 0;
+    while (escrito < tamano) {
+        ssize_t n = write(fd, (const char*) datos + escrito, tamano - escrito);
+        if (n == -1) {
+            if (errno == EINTR) continue;
+            perror("write");
+            return false;
+        }
+        escrito += (size_t) n;
+    }
+    return true;
+}
+
+//Ordena los eventos por segundo simulado y luego por equipo, y les da formato de consola en bloque
+//Lo usan el coordinador (eventos de los anillos) y la reproducción de trazas (eventos reconstruidos)
+void formatear_eventos(vector<EventoEquipo>& eventos, uint32_t descartados, string& bloque) {
+    stable_sort(eventos.begin(), eventos.end(), [](const EventoEquipo& a, const EventoEquipo& b) {
+        return a.t_simulado != b.t_simulado ? a.t_simulado < b.t_simulado : a.equipo < b.equipo;
+    });
+
+    bloque.clear();
+    for (const EventoEquipo& ev : eventos) {
+        const TipoEquipo& equipo = campamento.equipos[ev.equipo];
+        bloque += "[EQUIPO " + equipo.nombre + " - PID: " + to_string(ev.pid) + "] ";
+        switch (ev.fase) {
+            case FASE_EXPLORACION:  bloque += equipo.exploracion; break;
+            case FASE_RECOLECCION:  bloque += equipo.recoleccion; break;
+            case FASE_FINALIZACION: bloque += equipo.finalizacion; break;
+            default: bloque += "Completo ciclo: " + to_string(ev.unidades) + " unidades obtenidas"; break;
+        }
+        bloque += '\n';
+    }
+    if (descartados > 0) bloque += "[!] " + to_string(descartados) + " eventos descartados (anillo lleno)\n";
+}
+
+//Vacía los anillos de todos los equipos (lado consumidor) en eventos y cuenta los descartados
+//eventos es un buffer reutilizado entre días para no reservar memoria en cada uno
+void drenar_eventos(SharedMemoryData* shared_data, vector<EventoEquipo>& eventos, uint32_t& descartados) {
+    eventos.clear();
+    descartados = 0;
+    int e; fo(e, shared_data->num_equipos) {
+        AnilloEventos* anillo = anillo_equipo(shared_data, e);
+        uint32_t cola = anillo->cola;  // Solo el coordinador la escribe
+        uint32_t cabeza = __atomic_load_n(&anillo->cabeza, __ATOMIC_ACQUIRE);
+        for (; cola != cabeza; ++cola) eventos.push_back(anillo->eventos[cola & (CAPACIDAD_ANILLO - 1)]);
+        __atomic_store_n(&anillo->cola, cola, __ATOMIC_RELEASE);  // Liberar los espacios al productor
+        descartados += __atomic_exchange_n(&anillo->descartados, 0, __ATOMIC_RELAXED);
+    }
+}
+
+//Muestra los eventos ya drenados en una sola escritura
+//Los eventos se ordenan por segundo simulado y luego por equipo, así la salida no depende de cómo
+//el planificador intercale a los procesos
+void mostrar_eventos(vector<EventoEquipo>& eventos, uint32_t descartados, string& bloque) {
+    formatear_eventos(eventos, descartados, bloque);
+
+    cout.flush();  // Lo ya escrito por cout debe salir antes que el bloque
+    escribir_todo(STDOUT_FILENO, bloque.data(), bloque.size());
+}
+
+//Aplica los recursos de un día al estado de supervivencia (penalización de moral y racha de señales)
+//estado [in/out] Moral y señales consecutivas
+//recursos_dia Recursos totales recolectados en el día
+//reglas Mínimos y penalizaciones vigentes
+//EvaluacionDia Resultado de evaluar_supervivencia (sin texto)
+inline EvaluacionDia aplicar_dia(EstadoSupervivencia& estado, const Recursos& recursos_dia,
+                                 const ReglasSupervivencia& reglas) {
+    EvaluacionDia ev = evaluar_supervivencia(recursos_dia, reglas);
+
+    // Aplicar penalización a la moral
+    estado.moral -= ev.moral_perdida;
+    if (estado.moral < 0) estado.moral = 0;  // La moral nunca puede ser negativa
+
+    // Actualizar contador de señales consecutivas (se reinicia si no hay señales suficientes)
+    if (recursos_dia.cantidad[RECURSO_SENALES] >= reglas.minimo[RECURSO_SENALES]) ++estado.senales_consecutivas;
+    else estado.senales_consecutivas = 0;
+
+    return ev;
+}
+
+//Determina si la simulación terminó tras aplicar el día dia
+//fin [out] Forma de término (solo válido si retorna true)
+inline bool simulacion_terminada(const EstadoSupervivencia& estado, int dia, int dias_simulacion,
+                                 const ReglasSupervivencia& reglas, FinSimulacion& fin) {
+    if (estado.senales_consecutivas >= reglas.dias_rescate) { fin = FIN_RESCATE; return true; }
+    if (estado.moral <= 0) { fin = FIN_COLAPSO_MORAL; return true; }
+    if (dia >= dias_simulacion) { fin = FIN_LIMITE_TIEMPO; return true; }
+    return false;
+}
+
+//Datos de un día ya evaluado: todo lo necesario para mostrarlo por consola
+struct ResumenDia {
+    int dia;                       //Día de la simulación
+    vector<pid_t> pids;            //PID del proceso de cada equipo
+    vector<int> unidades;          //Unidades obtenidas por cada equipo
+    Recursos recursos;             //Unidades totales por tipo de recurso
+    int duracion_simulada;         //Duración simulada del día (s)
+    long long reloj_simulado;      //Reloj virtual al terminar el día (s)
+    EvaluacionDia evaluacion;      //Moral perdida y razones
+    EstadoSupervivencia estado;    //Moral y racha después de aplicar el día
+};
+
+//Muestra los reportes, resultados vs mínimos, racha y moral de un día
+void mostrar_dia(const ResumenDia& r) {
+    const ReglasSupervivencia& reglas = campamento.reglas;
+    const Recursos& recursos_dia = r.recursos;
+
+    // Mostrar reportes finales del día
+    cout << "\nREPORTES FINALES:" << endl;
+    for (size_t e = 0; e < r.unidades.size(); ++e) {
+        cout << "[#] Equipo " << campamento.equipos[e].nombre_reporte << " (PID: " << r.pids[e] << "): "
+             << r.unidades[e] << " unidades obtenidas" << endl;
+    }
+    cout << "[t] Duración simulada del día: " << r.duracion_simulada << " s (reloj virtual: "
+         << r.reloj_simulado << " s)" << endl;
+
+    // Mostrar resultados vs requisitos mínimos
+    cout << "\nRESULTADOS DEL DÍA:" << endl;
+    for (int k = 0; k < NUM_RECURSOS; ++k) {
+        cout << "[i] " << campamento.recursos[k].etiqueta << ": " << recursos_dia.cantidad[k] << "/"
+             << reglas.minimo[k] << " ("
+             << (recursos_dia.cantidad[k] >= reglas.minimo[k] ? "SUFICIENTE" : "INSUFICIENTE") << ")" << endl;
+    }
+
+    // Mostrar contador de señales consecutivas
+    if (recursos_dia.cantidad[RECURSO_SENALES] >= reglas.minimo[RECURSO_SENALES]) {
+        cout << "[✓] Señales activas: Día " << r.estado.senales_consecutivas << " consecutivo" << endl;
+    } else {
+        cout << "[✖] Señales insuficientes, contador reiniciado" << endl;
+    }
+
+    // Mostrar estado y moral actual
+    cout << "\nEstado: " << (r.evaluacion.razones == 0 ? "DÍA SUPERADO" : "SUPERVIVENCIA CRÍTICA") << endl;
+    cout << "Moral del grupo: " << r.estado.moral << "/100";
+    if (r.evaluacion.moral_perdida > 0) {
+        cout << " (-" << r.evaluacion.moral_perdida << " " << formatear_razones(r.evaluacion.razones) << ")";
+    } else {
+        cout << " (sin cambio)";
+    }
+    cout << endl;
+}
+
+//Muestra el mensaje de término de la simulación
+void mostrar_fin(FinSimulacion fin, const ResumenDia& r, int dias_simulacion) {
+    if (fin == FIN_RESCATE) {
+        // Victoria por rescate exitoso (ej: 10 días consecutivos con señales)
+        cout << "\n██▓▒░ ¡RESCATE EXITOSO! ░▒▓██" << endl;
+        cout << "Han mantenido señales activas por " << r.estado.senales_consecutivas << " días consecutivos" << endl;
+    } else if (fin == FIN_COLAPSO_MORAL) {
+        // Derrota por moral agotada
+        cout << "\n██▓▒░ FRACASO - MORAL AGOTADA ░▒▓██" << endl;
+        cout << "El grupo ha perdido la esperanza después de " << r.dia << " días" << endl;
+    } else {
+        // Fin por límite de tiempo sin victoria/derrota
+        cout << "\n██▓▒░ LÍMITE DE TIEMPO ALCANZADO ░▒▓██" << endl;
+        cout << "Sobrevivieron " << dias_simulacion << " días con moral " << r.estado.moral << "/100" << endl;
+        cout << "Señales activas consecutivas: " << r.estado.senales_consecutivas << "/"
+             << campamento.reglas.dias_rescate << endl;
+    }
+}
+
+//Muestra el encabezado de la simulación (también lo usa la reproducción de trazas)
+void mostrar_encabezado(const OpcionesSimulacion& opciones, int num_equipos, const string& modo) {
+    cout << "=== SISTEMA DE SUPERVIVENCIA ACTIVADO ===" << endl;
+    cout << "Moral inicial: " << campamento.reglas.moral_inicial << "/100" << endl;
+    cout << "Días de simulación: " << opciones.dias_simulacion << endl;
+    cout << "Equipos: " << num_equipos << endl;
+    cout << "Modo de equipos: " << modo << endl;
+    cout << "Escala de tiempo: " << opciones.escala_tiempo << " s reales por s simulado" << endl;
+    cout << "Semilla: " << opciones.semilla << " (use --seed para reproducir)" << endl << endl;
+}
+
+//Muestra las estadísticas de tiempo simulado (independientes de la escala de tiempo)
+void mostrar_tiempo_simulado(long long reloj_simulado, int dias_medidos,
+                             const vector<long long>& seg_exploracion_total,
+                             const vector<long long>& seg_recoleccion_total) {
+    cout << "\nTiempo simulado total: " << reloj_simulado << " s en " << dias_medidos << " días" << endl;
+    for (size_t i = 0; i < seg_exploracion_total.size(); ++i) {
+        cout << "[t] Equipo " << campamento.equipos[i].nombre << ": exploración promedio "
+             << (double) seg_exploracion_total[i] / dias_medidos << " s, recolección promedio "
+             << (double) seg_recoleccion_total[i] / dias_medidos << " s" << endl;
+    }
+}
+
+//Alinea texto UTF-8 a la derecha en ancho columnas (setw cuenta bytes, no caracteres acentuados)
+string alinear_derecha(const string& texto, int ancho) {
+    int caracteres = 0;
+    for (unsigned char c : texto) caracteres += (c & 0xC0) != 0x80;  // No contar bytes de continuación
+    return string(max(ancho - caracteres, 0), ' ') + texto;
+}
+
+//Muestra los histogramas de los tramos del día (--stats): muestras, p50, p99 y máximo en microsegundos
+void mostrar_estadisticas(const EstadisticasTramos& estadisticas) {
+    const char* nombres[NUM_TRAMOS] = {"arranque (fork/futex)", "enlace (shmat)", "exploración", "recolección",
+                                       "finalización", "despertar coordinador", "recoger (waitpid/join)", "día completo"};
+    cout << "\nESTADÍSTICAS DE TRAMOS (us, cubetas logarítmicas):" << endl;
+    cout << setw(22) << "tramo" << " | " << setw(8) << "muestras" << " | " << setw(10) << "p50"
+         << " | " << setw(10) << "p99" << " | " << alinear_derecha("máx", 10) << endl;
+    for (int t = 0; t < NUM_TRAMOS; ++t) {
+        const HistogramaLog& h = estadisticas.tramos[t];
+        if (h.muestras == 0) continue;
+        cout << alinear_derecha(nombres[t], 22) << " | " << setw(8) << h.muestras << " | "
+             << setw(10) << percentil_histograma(h, 0.50) / 1000.0 << " | "
+             << setw(10) << percentil_histograma(h, 0.99) / 1000.0 << " | "
+             << setw(10) << h.maximo / 1000.0 << endl;
+    }
+}
+
+//Traza Binaria
+//Formato del archivo (--trace): CabeceraTraza, el recurso de cada equipo (int32 por equipo, relleno
+//a 8 bytes) y bloques columnares de hasta FILAS_BLOQUE_TRAZA días. Cada bloque se agrega al final del
+//archivo al llenarse (solo se agrega, nunca se reescribe) y guarda cada campo como una columna contigua:
+//una consulta recorre solo las columnas que usa. Los enteros van en el orden de bytes de la máquina
+
+const char MAGIA_TRAZA[8] = {'S', 'U', 'P', 'T', 'R', 'Z', '1', '\0'};
+const uint32_t MAGIA_BLOQUE = 0x4b4c4254;  // "TBLK"
+const int FILAS_BLOQUE_TRAZA = 4096;       //Días por bloque
+
+//Cabecera del archivo de traza
+struct CabeceraTraza {
+    char magia[8];                  //MAGIA_TRAZA
+    int32_t num_equipos;            //Equipos (columnas por campo de equipo)
+    int32_t columnas_equipo;        //Campos por equipo: 5 (coordinador) o 1 (modo batch: solo unidades)
+    int32_t dias_simulacion;        //Días máximos de la simulación
+    int32_t equipos_persistentes;   //Modo de equipos del coordinador
+    double escala_tiempo;           //Escala del reloj virtual usada al grabar
+    uint64_t semilla;               //Semilla global
+    ReglasSupervivencia reglas;     //Reglas vigentes al grabar (la reproducción las restaura)
+};
+
+//Cabecera de cada bloque; le siguen las columnas: corrida (int64) y luego las columnas int32
+struct CabeceraBloque {
+    uint32_t magia;   //MAGIA_BLOQUE
+    uint32_t filas;   //Días guardados en el bloque
+};
+
+//Columnas int32 por día (después de la columna corrida)
+enum ColumnaDia {
+    COL_DIA = 0,
+    COL_MORAL,
+    COL_RACHA,
+    COL_MORAL_PERDIDA,
+    COL_RAZONES,
+    COL_DURACION,        //Duración simulada del día (s)
+    COL_FIN,             //FinSimulacion si la corrida terminó ese día, -1 si continúa
+    NUM_COLUMNAS_DIA
+};
+
+//Campos por equipo; cada uno ocupa num_equipos columnas int32 consecutivas
+enum CampoEquipo {
+    CAMPO_UNIDADES = 0,
+    CAMPO_PID,
+    CAMPO_SEG_EXPLORACION,
+    CAMPO_SEG_RECOLECCION,
+    CAMPO_SEG_FINALIZACION,
+    NUM_CAMPOS_EQUIPO
+};
+
+//Tamaño en bytes de un bloque de la traza con filas días (múltiplo de 8 para alinear el siguiente)
+size_t tamano_bloque_traza(int filas, int num_columnas) {
+    size_t tamano = sizeof(CabeceraBloque) + (size_t) filas * (sizeof(int64_t) + num_columnas * sizeof(int32_t));
+    return (tamano + 7) / 8 * 8;
+}
+
+//Serializa la escritura de bloques cuando varios hilos del modo batch graban en el mismo archivo
+mutex cerrojo_traza;
+
+//Bloque en construcción de un escritor de traza (uno por coordinador o por hilo del modo batch)
+//Las columnas se llenan en memoria y se escriben en una sola llamada al llenarse el bloque
+struct BloqueTraza {
+    int fd;                      //Archivo de traza (compartido entre escritores)
+    int num_columnas;            //NUM_COLUMNAS_DIA + columnas_equipo * num_equipos
+    int num_equipos;
+    int filas;                   //Días ya agregados al bloque
+    vector<int64_t> corrida;     //Columna corrida
+    vector<int32_t> columnas;    //Columna c en [c * FILAS_BLOQUE_TRAZA, (c + 1) * FILAS_BLOQUE_TRAZA)
+    vector<char> salida;         //Buffer reutilizado para escribir el bloque
+
+    BloqueTraza(int fd_traza, int equipos, int columnas_equipo)
+        : fd(fd_traza), num_columnas(NUM_COLUMNAS_DIA + columnas_equipo * equipos), num_equipos(equipos),
+          filas(0), corrida(FILAS_BLOQUE_TRAZA), columnas((size_t) num_columnas * FILAS_BLOQUE_TRAZA) {}
+
+    int32_t& celda(int columna, int fila) { return columnas[(size_t) columna * FILAS_BLOQUE_TRAZA + fila]; }
+    int32_t& celda_equipo(int campo, int equipo, int fila) {
+        return celda(NUM_COLUMNAS_DIA + campo * num_equipos + equipo, fila);
+    }
+};
+
+//Crea el archivo de traza y escribe su cabecera; termina el programa si no se puede crear
+int crear_traza(const string& ruta, const OpcionesSimulacion& opciones, int columnas_equipo) {
+    int fd = open(ruta.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) {
+        perror(("open " + ruta).c_str());
+        exit(1);
+    }
+    CabeceraTraza cabecera;
+    memset(&cabecera, 0, sizeof(cabecera));
+    memcpy(cabecera.magia, MAGIA_TRAZA, sizeof(MAGIA_TRAZA));
+    cabecera.num_equipos = (int32_t) campamento.equipos.size();
+    cabecera.columnas_equipo = columnas_equipo;
+    cabecera.dias_simulacion = opciones.dias_simulacion;
+    cabecera.equipos_persistentes = opciones.equipos_persistentes;
+    cabecera.escala_tiempo = opciones.escala_tiempo;
+    cabecera.semilla = opciones.semilla;
+    cabecera.reglas = campamento.reglas;
+
+    vector<int32_t> recurso_equipo((campamento.equipos.size() + 1) / 2 * 2, 0);  // Relleno a 8 bytes
+    for (size_t e = 0; e < campamento.equipos.size(); ++e) recurso_equipo[e] = campamento.equipos[e].recurso;
+
+    if (!escribir_todo(fd, &cabecera, sizeof(cabecera)) ||
+        !escribir_todo(fd, recurso_equipo.data(), recurso_equipo.size() * sizeof(int32_t))) {
+        exit(1);
+    }
+    return fd;
+}
+
+//Agrega el bloque en construcción al final del archivo (una sola escritura) y lo deja vacío
+void vaciar_bloque_traza(BloqueTraza& bloque) {
+    if (bloque.filas == 0) return;
+    int filas = bloque.filas;
+    bloque.salida.assign(tamano_bloque_traza(filas, bloque.num_columnas), 0);
+    char* p = bloque.salida.data();
+    CabeceraBloque cabecera = {MAGIA_BLOQUE, (uint32_t) filas};
+    memcpy(p, &cabecera, sizeof(cabecera));
+    p += sizeof(cabecera);
+    memcpy(p, bloque.corrida.data(), filas * sizeof(int64_t));
+    p += filas * sizeof(int64_t);
+    for (int c = 0; c < bloque.num_columnas; ++c) {
+        memcpy(p, &bloque.celda(c, 0), filas * sizeof(int32_t));
+        p += filas * sizeof(int32_t);
+    }
+    {
+        lock_guard<mutex> guardia(cerrojo_traza);
+        if (!escribir_todo(bloque.fd, bloque.salida.data(), bloque.salida.size())) exit(1);
+    }
+    bloque.filas = 0;
+}
+
+//Reserva la fila del siguiente día en el bloque (vaciándolo antes si está lleno) y guarda el estado del día
+//Los campos por equipo los completa quien llama con celda_equipo()
+int agregar_dia_traza(BloqueTraza& bloque, long long corrida, int dia, const EstadoSupervivencia& estado,
+                      const EvaluacionDia& evaluacion, int duracion, int fin) {
+    if (bloque.filas == FILAS_BLOQUE_TRAZA) vaciar_bloque_traza(bloque);
+    int fila = bloque.filas++;
+    bloque.corrida[fila] = corrida;
+    bloque.celda(COL_DIA, fila) = dia;
+    bloque.celda(COL_MORAL, fila) = estado.moral;
+    bloque.celda(COL_RACHA, fila) = estado.senales_consecutivas;
+    bloque.celda(COL_MORAL_PERDIDA, fila) = evaluacion.moral_perdida;
+    bloque.celda(COL_RAZONES, fila) = (int32_t) evaluacion.razones;
+    bloque.celda(COL_DURACION, fila) = duracion;
+    bloque.celda(COL_FIN, fila) = fin;
+    return fila;
+}
+
+//Traza abierta en memoria con mmap (solo lectura)
+struct TrazaMapeada {
+    const char* base;                //Inicio del archivo mapeado
+    size_t tamano;                   //Tamaño del archivo
+    const CabeceraTraza* cabecera;
+    const int32_t* recurso_equipo;   //Recurso de cada equipo
+    size_t inicio_bloques;           //Desplazamiento del primer bloque
+};
+
+//Vista de un bloque dentro del archivo mapeado (punteros a sus columnas, sin copiar datos)
+struct VistaBloque {
+    int filas;
+    int num_equipos;
+    const int64_t* corrida;
+    const int32_t* columnas;   //Primera columna int32; la columna c empieza en columnas + c * filas
+
+    const int32_t* columna(int c) const { return columnas + (size_t) c * filas; }
+    const int32_t* columna_equipo(int campo, int equipo) const {
+        return columna(NUM_COLUMNAS_DIA + campo * num_equipos + equipo);
+    }
+};
+
+//Mapea un archivo de traza y valida su cabecera
+//bool false con el motivo en error si el archivo no existe o no es una traza válida
+bool abrir_traza(const string& ruta, TrazaMapeada& traza, string& error) {
+    int fd = open(ruta.c_str(), O_RDONLY);
+    struct stat info;
+    if (fd == -1 || fstat(fd, &info) == -1) {
+        error = "no se pudo abrir " + ruta + ": " + strerror(errno);
+        if (fd != -1) close(fd);
+        return false;
+    }
+    traza.tamano = (size_t) info.st_size;
+    if (traza.tamano < sizeof(CabeceraTraza)) {
+        close(fd);
+        error = ruta + " no es una traza de supervivencia";
+        return false;
+    }
+    void* mapa = mmap(NULL, traza.tamano, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // El mapeo sigue vigente después de cerrar el descriptor
+    if (mapa == MAP_FAILED) {
+        error = string("mmap: ") + strerror(errno);
+        return false;
+    }
+    madvise(mapa, traza.tamano, MADV_SEQUENTIAL);  // Las consultas recorren el archivo de principio a fin
+
+    traza.base = (const char*) mapa;
+    traza.cabecera = (const CabeceraTraza*) traza.base;
+    traza.recurso_equipo = (const int32_t*) (traza.base + sizeof(CabeceraTraza));
+    int num_equipos = traza.cabecera->num_equipos;
+    traza.inicio_bloques = sizeof(CabeceraTraza) + (size_t) (num_equipos + 1) / 2 * 2 * sizeof(int32_t);
+    if (memcmp(traza.cabecera->magia, MAGIA_TRAZA, sizeof(MAGIA_TRAZA)) != 0 || num_equipos < 1 ||
+        num_equipos > MAX_EQUIPOS || traza.inicio_bloques > traza.tamano ||
+        (traza.cabecera->columnas_equipo != 1 && traza.cabecera->columnas_equipo != NUM_CAMPOS_EQUIPO)) {
+        munmap(mapa, traza.tamano);
+        error = ruta + " no es una traza de supervivencia";
+        return false;
+    }
+    return true;
+}
+
+//Avanza al bloque que empieza en desplazamiento; retorna false al final del archivo
+//Un bloque truncado (grabación interrumpida) se trata como fin de la traza
+bool siguiente_bloque(const TrazaMapeada& traza, size_t& desplazamiento, VistaBloque& vista) {
+    if (desplazamiento + sizeof(CabeceraBloque) > traza.tamano) return false;
+    const CabeceraBloque* cabecera = (const CabeceraBloque*) (traza.base + desplazamiento);
+    int num_columnas = NUM_COLUMNAS_DIA + traza.cabecera->columnas_equipo * traza.cabecera->num_equipos;
+    size_t tamano = tamano_bloque_traza((int) cabecera->filas, num_columnas);
+    if (cabecera->magia != MAGIA_BLOQUE || desplazamiento + tamano > traza.tamano) return false;
+
+    vista.filas = (int) cabecera->filas;
+    vista.num_equipos = traza.cabecera->num_equipos;
+    vista.corrida = (const int64_t*) (traza.base + desplazamiento + sizeof(CabeceraBloque));
+    vista.columnas = (const int32_t*) (vista.corrida + vista.filas);
+    desplazamiento += tamano;
+    return true;
+}
+
+//Reproduce la salida de consola de una corrida grabada (--replay), sin volver a simular
+//Reutiliza mostrar_dia/mostrar_fin; los mensajes de los equipos se reconstruyen desde las duraciones
+//de sus fases. Los nombres y mensajes salen de la configuración actual (usar el mismo --config/--teams)
+//Las métricas de tiempo real (sobrecarga, despertar) no se graban y no se muestran
+int reproducir_traza(const string& ruta, long long corrida_buscada) {
+    TrazaMapeada traza;
+    string error;
+    if (!abrir_traza(ruta, traza, error)) {
+        cout << "Error: " << error << endl;
+        return 1;
+    }
+    const CabeceraTraza& cab = *traza.cabecera;
+    int num_equipos = cab.num_equipos;
+    bool hay_error = num_equipos != (int) campamento.equipos.size();
+    for (int e = 0; e < num_equipos && !hay_error; ++e) {
+        hay_error = traza.recurso_equipo[e] != campamento.equipos[e].recurso;
+    }
+    if (hay_error) {
+        cout << "Error: los " << num_equipos << " equipos de la traza no coinciden con la configuración actual "
+             << "(use el mismo --config/--teams con que se grabó)" << endl;
+        munmap((void*) traza.base, traza.tamano);
+        return 1;
+    }
+    campamento.reglas = cab.reglas;  // Reglas con que se grabó
+    bool con_fases = cab.columnas_equipo == NUM_CAMPOS_EQUIPO;
+
+    OpcionesSimulacion opciones;
+    opciones.dias_simulacion = cab.dias_simulacion;
+    opciones.equipos_persistentes = cab.equipos_persistentes;
+    opciones.escala_tiempo = cab.escala_tiempo;
+    opciones.semilla = cab.semilla;
+    mostrar_encabezado(opciones, num_equipos, opciones.equipos_persistentes ? "persistentes" : "fork por día");
+
+    ResumenDia resumen;
+    resumen.pids.assign(num_equipos, 0);
+    resumen.unidades.assign(num_equipos, 0);
+    vector<EventoEquipo> eventos;
+    string bloque_eventos;
+    vector<long long> seg_exploracion_total(num_equipos, 0), seg_recoleccion_total(num_equipos, 0);
+    long long reloj_simulado = 0;
+    int dias = 0;
+    bool terminada = false;
+
+    size_t desplazamiento = traza.inicio_bloques;
+    VistaBloque vista;
+    while (!terminada && siguiente_bloque(traza, desplazamiento, vista)) {
+        for (int f = 0; f < vista.filas && !terminada; ++f) {
+            if (vista.corrida[f] != corrida_buscada) continue;
+            int dia = vista.columna(COL_DIA)[f];
+            if (dias > 0) cout << "\n----------------------------------------\n" << endl;
+            cout << "=== DÍA " << dia << " DE SUPERVIVENCIA ===" << endl;
+            cout << "Iniciando equipos de recolección..." << endl << endl;
+
+            Recursos recursos_dia = {{0, 0, 0, 0}};
+            eventos.clear();
+            for (int e = 0; e < num_equipos; ++e) {
+                resumen.unidades[e] = vista.columna_equipo(CAMPO_UNIDADES, e)[f];
+                recursos_dia.cantidad[traza.recurso_equipo[e]] += resumen.unidades[e];
+                if (!con_fases) continue;
+                pid_t pid = vista.columna_equipo(CAMPO_PID, e)[f];
+                int exploracion = vista.columna_equipo(CAMPO_SEG_EXPLORACION, e)[f];
+                int recoleccion = vista.columna_equipo(CAMPO_SEG_RECOLECCION, e)[f];
+                int finalizacion = vista.columna_equipo(CAMPO_SEG_FINALIZACION, e)[f];
+                resumen.pids[e] = pid;
+                seg_exploracion_total[e] += exploracion;
+                seg_recoleccion_total[e] += recoleccion;
+                eventos.push_back({e, pid, FASE_EXPLORACION, 0, 0, 0, 0});
+                eventos.push_back({e, pid, FASE_RECOLECCION, 0, exploracion, 0, 0});
+                eventos.push_back({e, pid, FASE_FINALIZACION, 0, exploracion + recoleccion, 0, 0});
+                eventos.push_back({e, pid, FASE_COMPLETADO, resumen.unidades[e],
+                                   exploracion + recoleccion + finalizacion, 0, 0});
+            }
+            formatear_eventos(eventos, 0, bloque_eventos);
+            cout << bloque_eventos;
+
+            if (dias > 0 && con_fases) reloj_simulado += 1;  // Pausa entre días (el modo batch no tiene reloj)
+            reloj_simulado += vista.columna(COL_DURACION)[f];
+            ++dias;
+            resumen.dia = dia;
+            resumen.recursos = recursos_dia;
+            resumen.duracion_simulada = vista.columna(COL_DURACION)[f];
+            resumen.reloj_simulado = reloj_simulado;
+            resumen.evaluacion = {vista.columna(COL_MORAL_PERDIDA)[f], (unsigned) vista.columna(COL_RAZONES)[f]};
+            resumen.estado = {vista.columna(COL_MORAL)[f], vista.columna(COL_RACHA)[f]};
+            mostrar_dia(resumen);
+
+            int fin = vista.columna(COL_FIN)[f];
+            if (fin >= 0) {
+                mostrar_fin((FinSimulacion) fin, resumen, cab.dias_simulacion);
+                if (fin == FIN_RESCATE) {
+                    cout << "\n██▓▒░ FELICIDADES - MISIÓN CUMPLIDA ░▒▓██" << endl;
+                    cout << "Todos los sobrevivientes han sido rescatados exitosamente" << endl;
+                }
+                terminada = true;
+            }
+        }
+    }
+    munmap((void*) traza.base, traza.tamano);
+
+    if (dias == 0) {
+        cout << "Error: la corrida " << corrida_buscada << " no está en la traza" << endl;
+        return 1;
+    }
+    if (con_fases) mostrar_tiempo_simulado(reloj_simulado, dias, seg_exploracion_total, seg_recoleccion_total);
+    return 0;
+}
+
+//Responde consultas agregadas sobre una traza (--query) recorriendo sus columnas mapeadas, sin simular:
+//corridas y días grabados, forma de término, días promedio hasta el colapso o el rescate,
+//moral promedio y unidades promedio por equipo
+int consultar_traza(const string& ruta) {
+    TrazaMapeada traza;
+    string error;
+    if (!abrir_traza(ruta, traza, error)) {
+        cout << "Error: " << error << endl;
+        return 1;
+    }
+    long long t_inicio = ahora_ns();
+    int num_equipos = traza.cabecera->num_equipos;
+    long long dias = 0, suma_moral = 0;
+    long long fines[3] = {0, 0, 0}, suma_dia_fin[3] = {0, 0, 0};
+    vector<long long> suma_unidades(num_equipos, 0);
+
+    size_t desplazamiento = traza.inicio_bloques;
+    VistaBloque vista;
+    while (siguiente_bloque(traza, desplazamiento, vista)) {
+        int n = vista.filas;
+        dias += n;
+        const int32_t* moral = vista.columna(COL_MORAL);
+        const int32_t* fin = vista.columna(COL_FIN);
+        const int32_t* dia = vista.columna(COL_DIA);
+        for (int f = 0; f < n; ++f) {
+            suma_moral += moral[f];
+            if (fin[f] >= 0 && fin[f] < 3) {
+                ++fines[fin[f]];
+                suma_dia_fin[fin[f]] += dia[f];
+            }
+        }
+        for (int e = 0; e < num_equipos; ++e) {
+            const int32_t* unidades = vista.columna_equipo(CAMPO_UNIDADES, e);
+            long long suma = 0;
+            for (int f = 0; f < n; ++f) suma += unidades[f];
+            suma_unidades[e] += suma;
+        }
+    }
+    double segundos = (ahora_ns() - t_inicio) / 1e9;
+    size_t tamano = traza.tamano;
+    uint64_t semilla = traza.cabecera->semilla;
+    munmap((void*) traza.base, traza.tamano);
+
+    long long corridas = fines[0] + fines[1] + fines[2];
+    const char* nombres_fin[3] = {"Rescate exitoso", "Colapso de moral", "Límite de tiempo"};
+    cout << "=== CONSULTA DE TRAZA ===" << endl;
+    cout << "Archivo: " << ruta << " (" << tamano / 1024 << " KiB), equipos: " << num_equipos
+         << ", semilla: " << semilla << endl;
+    cout << "Corridas completas: " << corridas << ", días grabados: " << dias << endl;
+    if (dias == 0) return 0;
+    int k; fo(k, 3) {
+        cout << "[i] " << nombres_fin[k] << ": " << fines[k];
+        if (corridas > 0) cout << " (" << 100.0 * fines[k] / corridas << "%)";
+        if (fines[k] > 0) cout << ", día promedio " << (double) suma_dia_fin[k] / fines[k];
+        cout << endl;
+    }
+    cout << "Moral promedio por día: " << (double) suma_moral / dias << endl;
+    cout << "Unidades promedio por día:" << endl;
+    for (int e = 0; e < num_equipos; ++e) {
+        string nombre = e < (int) campamento.equipos.size() ? campamento.equipos[e].nombre : "#" + to_string(e);
+        cout << "  Equipo " << nombre << ": " << (double) suma_unidades[e] / dias << endl;
+    }
+    cout << "Tiempo de consulta: " << segundos * 1000 << " ms ("
+         << (long long) (dias / max(segundos, 1e-9)) << " días/s)" << endl;
+    return 0;
+}
+
+//Dispersión de una serie de tiempos por día (jitter): desviación y percentiles, en ns
+struct ResumenJitter {
+    double promedio, desviacion;
+    long long p50, p99, maximo;
+};
+
+ResumenJitter resumir_jitter(vector<long long> muestras) {
+    ResumenJitter r = {0, 0, 0, 0, 0};
+    if (muestras.empty()) return r;
+    sort(muestras.begin(), muestras.end());
+    double suma = 0, suma_cuadrados = 0;
+    for (long long x : muestras) suma += (double) x;
+    r.promedio = suma / muestras.size();
+    for (long long x : muestras) suma_cuadrados += (x - r.promedio) * (x - r.promedio);
+    r.desviacion = muestras.size() > 1 ? sqrt(suma_cuadrados / (muestras.size() - 1)) : 0;
+    r.p50 = muestras[(muestras.size() - 1) / 2];
+    r.p99 = muestras[(size_t) ceil(0.99 * muestras.size()) - 1];
+    r.maximo = muestras.back();
+    return r;
+}
+
+//Función del Coordinador (Proceso Padre)
+
+//Función principal que coordina toda la simulación
+//opciones.dias_simulacion Número de días a simular (entre 10 y 30)
+//MetricasCoordinador Latencia y sobrecarga promedio por día (tiempo real)
+
+//Crea la memoria compartida, gestiona los procesos hijos y evalúa el progreso
+//Controla las condiciones de victoria/derrota y muestra el estado de la simulación
+//La cantidad de equipos y el tamaño del segmento salen de la configuración del campamento
+//Los equipos los ejecuta el backend elegido con --backend (procesos, hilos o pool); con
+//opciones.equipos_persistentes se crean una sola vez y se sincronizan por día mediante la
+//barrera ciclo_inicio/equipos_completados de la memoria compartida
+MetricasCoordinador coordinador(const OpcionesSimulacion& opciones) {
+    int dias_simulacion = opciones.dias_simulacion;
+    const ReglasSupervivencia& reglas = campamento.reglas;
+    int num_equipos = (int) campamento.equipos.size();
+    EstadoSupervivencia estado = {reglas.moral_inicial, 0}; // Moral inicial y contador de días consecutivos con señales
+    bool rescate_exitoso = false;            // Bandera de victoria por rescate
+    bool resumen_final = !opciones.solo_metricas; // Encabezado, término y estadísticas por consola
+
+    // Afinidad, política y nodo NUMA (--cpus, --sched, --numa): antes de crear la memoria y los equipos
+    string afinidad = configurar_afinidad(opciones);
+
+    // Backend que ejecuta a los equipos (procesos, hilos o pool) y encabezado de la simulación
+    unique_ptr<BackendEquipos> backend = crear_backend(opciones);
+    if (resumen_final) mostrar_encabezado(opciones, num_equipos, backend->descripcion());
+
+    // Memoria de la simulación (segmento SysV en el backend de procesos, heap en los de hilos), a cero
+    SharedMemoryData* shared_data = backend->crear_memoria(tamano_memoria(num_equipos));
+    shared_data->num_equipos = num_equipos;
+    shared_data->escala_tiempo = opciones.escala_tiempo;
+    shared_data->semilla = opciones.semilla;
+    shared_data->silencioso = opciones.silencioso;
+    shared_data->falla_equipo = opciones.falla_equipo;
+    shared_data->falla_dia = opciones.falla_dia;
+    shared_data->falla_colgar = opciones.falla_colgar;
+    shared_data->falla_pendiente = opciones.falla_dia > 0;
+
+    // Crear el eventfd de término (lo heredan los hijos) y el epoll donde el coordinador se bloquea
+    shared_data->evento_fd = eventfd(0, EFD_NONBLOCK);
+    int epoll_fd = epoll_create1(0);
+    struct epoll_event ev_evento;
+    ev_evento.events = EPOLLIN;
+    ev_evento.data.u64 = ETIQUETA_EVENTFD;
+    if (shared_data->evento_fd == -1 || epoll_fd == -1 ||
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, shared_data->evento_fd, &ev_evento) == -1) {
+        perror("eventfd/epoll (padre)");
+        backend->terminar(shared_data);
+        exit(1);
+    }
+
+    // Equipos persistentes: se crean una sola vez antes del primer día
+    backend->iniciar(shared_data, epoll_fd);
+    int i;
+
+    // Medición de la sobrecarga de coordinación: tiempo total del día menos el trabajo del equipo más lento
+    long long sobrecarga_total_ns = 0, sobrecarga_max_ns = 0;
+    // Latencia de despertar: desde que el último equipo termina hasta que el coordinador lo nota
+    long long despertar_total_ns = 0, despertar_max_ns = 0;
+    long long latencia_total_ns = 0;  // Tiempo real de cada día (inicio hasta reportes recogidos)
+    int dias_medidos = 0;
+    vector<long long> sobrecargas_ns, despertares_ns;  // Series por día para el jitter
+
+    // Reloj virtual de la simulación (segundos simulados) y acumulados de fases por equipo
+    long long reloj_simulado = 0;
+    vector<long long> seg_exploracion_total(num_equipos, 0);
+    vector<long long> seg_recoleccion_total(num_equipos, 0);
+
+    // Resumen del día, reutilizado entre días para no reservar memoria en cada uno
+    ResumenDia resumen;
+    resumen.pids.resize(num_equipos);
+    resumen.unidades.resize(num_equipos);
+    vector<EventoEquipo> eventos;  // Buffers de drenar_eventos y mostrar_eventos, reutilizados entre días
+    string bloque_eventos;
+    eventos.reserve((size_t) num_equipos * CAPACIDAD_ANILLO);
+
+    // Traza binaria opcional (--trace): un día por fila, con unidades, PID y fases de cada equipo
+    int fd_traza = opciones.archivo_traza.empty() ? -1 : crear_traza(opciones.archivo_traza, opciones, NUM_CAMPOS_EQUIPO);
+    BloqueTraza bloque_traza(fd_traza, fd_traza == -1 ? 0 : num_equipos, NUM_CAMPOS_EQUIPO);
+
+    // Ranura de reportes del día (reportes_dia) y prepara y lanza el día; anota su inicio real
+    long long t_inicio_dia[NUM_RANURAS_REPORTE] = {0, 0};
+    auto lanzar = [&](int dia) {
+        t_inicio_dia[dia % NUM_RANURAS_REPORTE] = ahora_ns(); // Inicio de la coordinación del día
+
+        // Inicializar datos del día en memoria compartida (en la ranura del día)
+        ReporteEquipo* reportes = reportes_dia(shared_data, dia);
+        shared_data->equipos_completados = 0;
+        shared_data->dia_actual = dia;
+        fo(i, num_equipos) {
+            reportes[i].id_equipo = i;
+            reportes[i].recursos_recolectados = 0;
+            reportes[i].estado_equipo = 0;  // Estado: trabajando
+            reportes[i].pid_equipo = 0;
+            // Un equipo que muere sin reportar no debe dejar valores de hace dos días en la ranura
+            reportes[i].seg_exploracion = reportes[i].seg_recoleccion = reportes[i].seg_finalizacion = 0;
+            reportes[i].t_entrada_ns = reportes[i].t_inicio_ns = reportes[i].t_recoleccion_ns = 0;
+            reportes[i].t_finalizacion_ns = reportes[i].t_fin_ns = 0;
+        }
+
+        // Poner a trabajar a los equipos (fork, barrera o tareas, según el backend)
+        backend->lanzar_dia(shared_data, dia);
+    };
+    // Plazo real de cada día desde su lanzamiento (supervisión del backend de procesos)
+    // Automático: el doble del día más largo posible a la escala de tiempo, más 2 s de margen
+    const int SEG_MAX_DIA = 4 + 4 + 1;  // Exploración + recolección + finalización más largas
+    long long plazo_ns = opciones.plazo_ms >= 0 ? opciones.plazo_ms * 1000000LL
+                                                : (long long) ((2 * SEG_MAX_DIA * opciones.escala_tiempo + 2) * 1e9);
+    auto limite_dia = [&](int dia) {
+        return plazo_ns > 0 ? t_inicio_dia[dia % NUM_RANURAS_REPORTE] + plazo_ns : 0;
+    };
+    auto mostrar_inicio_dia = [&](int dia) {
+        cout << "=== DÍA " << dia << " DE SUPERVIVENCIA ===" << endl;
+        cout << "Iniciando equipos de recolección..." << endl << endl;
+    };
+
+    // Bucle principal de días de simulación
+    // Con --pipeline el día siguiente se lanza apenas se recogen los reportes del actual (en la otra ranura),
+    // así los equipos trabajan mientras el coordinador evalúa y muestra; la moral se aplica en orden igual
+    long long t_simulacion = ahora_ns();
+    int dia_descartado = 0;  // Pipeline: día lanzado después del término (0: ninguno)
+    for (int dia = 1; dia <= dias_simulacion; ++dia) { // Hasta rescate, colapso o límite (simulacion_terminada)
+        if (!opciones.pipeline || dia == 1) {
+            if (!opciones.silencioso && !opciones.pipeline) mostrar_inicio_dia(dia);
+            lanzar(dia);
+        }
+
+        // Esperar a que todos los equipos completen su trabajo (o se den por fallidos al vencer el plazo)
+        backend->esperar_dia(shared_data, epoll_fd, opciones.espera_polling, dia, limite_dia(dia));
+        long long despertar_ns = ahora_ns() - shared_data->t_ultimo_ns;
+        despertar_total_ns += despertar_ns;
+        despertar_max_ns = max(despertar_max_ns, despertar_ns);
+        despertares_ns.push_back(despertar_ns);
+        EstadisticasTramos& estadisticas = shared_data->estadisticas;
+        registrar_muestra(estadisticas.tramos[TRAMO_DESPERTAR], despertar_ns);
+
+        // Vaciar los anillos antes de lanzar el día siguiente (sus eventos no se mezclan con los de este)
+        uint32_t descartados = 0;
+        if (!opciones.silencioso) drenar_eventos(shared_data, eventos, descartados);
+
+        // Recoger a los equipos del día (waitpid de los hijos o join de los hilos, según el backend)
+        backend->recoger_dia(shared_data);
+        long long latencia_ns = ahora_ns() - t_inicio_dia[dia % NUM_RANURAS_REPORTE];
+
+        // Pipeline: el día siguiente se lanza ya (escribe en la otra ranura); si este día resulta el último,
+        // sus resultados se descartan
+        bool siguiente_lanzado = opciones.pipeline && dia < dias_simulacion;
+        if (siguiente_lanzado) lanzar(dia + 1);
+
+        // Mostrar los mensajes de los equipos del día, ordenados, en una sola escritura
+        if (!opciones.silencioso) {
+            if (opciones.pipeline) mostrar_inicio_dia(dia);
+            mostrar_eventos(eventos, descartados, bloque_eventos);
+        }
+
+        // Recoger resultados de la ranura del día, acumulando por tipo de recurso
+        const ReporteEquipo* reportes = reportes_dia(shared_data, dia);
+        Recursos recursos_dia = {{0, 0, 0, 0}};
+        fo(i, num_equipos) {
+            resumen.unidades[i] = reportes[i].recursos_recolectados;
+            resumen.pids[i] = reportes[i].pid_equipo;
+            recursos_dia.cantidad[campamento.equipos[i].recurso] += resumen.unidades[i];
+        }
+
+        // Sobrecarga del día: lo que no fue trabajo de los equipos (fork, shmat, espera, waitpid)
+        long long trabajo_max_ns = 0;
+        fo(i, num_equipos) {
+            trabajo_max_ns = max(trabajo_max_ns, reportes[i].t_fin_ns - reportes[i].t_inicio_ns);
+        }
+        long long sobrecarga_ns = latencia_ns - trabajo_max_ns;
+        registrar_muestra(estadisticas.tramos[TRAMO_DIA], latencia_ns);
+        fo(i, num_equipos) {
+            const ReporteEquipo& r = reportes[i];
+            registrar_muestra(estadisticas.tramos[TRAMO_ARRANQUE], r.t_entrada_ns - r.t_lanzamiento_ns);
+            registrar_muestra(estadisticas.tramos[TRAMO_ENLACE], r.t_inicio_ns - r.t_entrada_ns);
+            registrar_muestra(estadisticas.tramos[TRAMO_EXPLORACION], r.t_recoleccion_ns - r.t_inicio_ns);
+            registrar_muestra(estadisticas.tramos[TRAMO_RECOLECCION], r.t_finalizacion_ns - r.t_recoleccion_ns);
+            registrar_muestra(estadisticas.tramos[TRAMO_FINALIZACION], r.t_fin_ns - r.t_finalizacion_ns);
+        }
+        latencia_total_ns += latencia_ns;
+        sobrecarga_total_ns += sobrecarga_ns;
+        sobrecarga_max_ns = max(sobrecarga_max_ns, sobrecarga_ns);
+        sobrecargas_ns.push_back(sobrecarga_ns);
+        ++dias_medidos;
+
+        // Avanzar el reloj virtual: el día dura lo que tarda el equipo más lento
+        int duracion_dia = 0;
+        fo(i, num_equipos) {
+            const ReporteEquipo& r = reportes[i];
+            duracion_dia = max(duracion_dia, r.seg_exploracion + r.seg_recoleccion + r.seg_finalizacion);
+            seg_exploracion_total[i] += r.seg_exploracion;
+            seg_recoleccion_total[i] += r.seg_recoleccion;
+        }
+        reloj_simulado += duracion_dia;
+
+        // Evaluar supervivencia y calcular penalizaciones (camino caliente: sin texto)
+        resumen.dia = dia;
+        resumen.recursos = recursos_dia;
+        resumen.duracion_simulada = duracion_dia;
+        resumen.reloj_simulado = reloj_simulado;
+        resumen.evaluacion = aplicar_dia(estado, recursos_dia, reglas);
+        resumen.estado = estado;
+
+        // Mostrar el día solo si la salida está habilitada (el texto se construye aquí y no antes)
+        if (!opciones.silencioso) mostrar_dia(resumen);
+
+        // Verificar condiciones de victoria/derrota/límite
+        FinSimulacion fin;
+        bool terminada = simulacion_terminada(estado, dia, dias_simulacion, reglas, fin);
+
+        if (fd_traza != -1) {
+            int fila = agregar_dia_traza(bloque_traza, 0, dia, estado, resumen.evaluacion, duracion_dia,
+                                         terminada ? fin : -1);
+            fo(i, num_equipos) {
+                const ReporteEquipo& r = reportes[i];
+                bloque_traza.celda_equipo(CAMPO_UNIDADES, i, fila) = resumen.unidades[i];
+                bloque_traza.celda_equipo(CAMPO_PID, i, fila) = resumen.pids[i];
+                bloque_traza.celda_equipo(CAMPO_SEG_EXPLORACION, i, fila) = r.seg_exploracion;
+                bloque_traza.celda_equipo(CAMPO_SEG_RECOLECCION, i, fila) = r.seg_recoleccion;
+                bloque_traza.celda_equipo(CAMPO_SEG_FINALIZACION, i, fila) = r.seg_finalizacion;
+            }
+        }
+
+        if (terminada) {
+            if (resumen_final) mostrar_fin(fin, resumen, dias_simulacion);
+            rescate_exitoso = (fin == FIN_RESCATE);
+            if (siguiente_lanzado) dia_descartado = dia + 1;
+            break;
+        }
+
+        if (!opciones.silencioso) cout << "\n----------------------------------------\n" << endl;
+        esperar_simulado(1, opciones.escala_tiempo);  // Pausa breve entre días para legibilidad
+        reloj_simulado += 1;
+    }
+    long long t_simulacion_total = ahora_ns() - t_simulacion;
+
+    // Día lanzado de más por el pipeline: el resultado ya está; esperar a sus equipos y descartarlo
+    if (dia_descartado > 0) {
+        uint32_t descartados;
+        backend->esperar_dia(shared_data, epoll_fd, opciones.espera_polling, dia_descartado, limite_dia(dia_descartado));
+        if (!opciones.silencioso) drenar_eventos(shared_data, eventos, descartados);
+        backend->recoger_dia(shared_data);
+    }
+
+    // Mensaje final de victoria (si aplica)
+    if (rescate_exitoso && resumen_final) {
+        cout << "\n██▓▒░ FELICIDADES - MISIÓN CUMPLIDA ░▒▓██" << endl;
+        cout << "Todos los sobrevivientes han sido rescatados exitosamente" << endl;
+    }
+
+    // Reporte de la sobrecarga de coordinación por día
+    if (dias_medidos > 0 && resumen_final) {
+        cout << "\nSobrecarga de coordinación por día (" 
+             << backend->descripcion() << "): promedio "
+             << (sobrecarga_total_ns / dias_medidos) / 1000 << " us, máximo "
+             << sobrecarga_max_ns / 1000 << " us" << endl;
+        cout << "Latencia de despertar del coordinador (" << (opciones.espera_polling ? "polling 100ms" : "eventfd/epoll")
+             << "): promedio " << (despertar_total_ns / dias_medidos) / 1000 << " us, máximo "
+             << despertar_max_ns / 1000 << " us" << endl;
+        cout << "Tiempo real por día (" << (opciones.pipeline ? "pipeline" : "en serie") << "): "
+             << (t_simulacion_total / dias_medidos) / 1000 << " us" << endl;
+        ResumenJitter jitter = resumir_jitter(sobrecargas_ns);
+        cout << "Jitter de la sobrecarga por día: desviación " << (long long) jitter.desviacion / 1000 << " us, p50 "
+             << jitter.p50 / 1000 << " us, p99 " << jitter.p99 / 1000 << " us (despertar: desviación "
+             << (long long) resumir_jitter(despertares_ns).desviacion / 1000 << " us)" << endl;
+        if (!afinidad.empty()) cout << "Afinidad y planificación: " << afinidad << endl;
+        if (backend->relanzados > 0 || backend->fallidos > 0) {
+            cout << "Supervisión de equipos: " << backend->relanzados << " relanzados, " << backend->fallidos
+                 << " equipos-día fallidos (plazo por día: " << plazo_ns / 1000000 << " ms)" << endl;
+        }
+
+        // Estadísticas de tiempo simulado (independientes de la escala de tiempo)
+        mostrar_tiempo_simulado(reloj_simulado, dias_medidos, seg_exploracion_total, seg_recoleccion_total);
+    }
+    if (dias_medidos > 0 && opciones.estadisticas) mostrar_estadisticas(shared_data->estadisticas);
+
+    if (fd_traza != -1) {
+        vaciar_bloque_traza(bloque_traza);
+        close(fd_traza);
+    }
+
+    close(epoll_fd);
+    close(shared_data->evento_fd);
+
+    // Terminar los equipos persistentes y liberar la memoria (shmdt + IPC_RMID en el backend de procesos)
+    backend->terminar(shared_data);
+
+    restaurar_afinidad();
+
+    MetricasCoordinador metricas = {dias_medidos, 0, 0, sobrecargas_ns, despertares_ns};
+    if (dias_medidos > 0) {
+        metricas.latencia_dia_us = latencia_total_ns / 1000.0 / dias_medidos;
+        metricas.sobrecarga_dia_us = sobrecarga_total_ns / 1000.0 / dias_medidos;
+    }
+    return metricas;
+}
+
+//Mide cómo escala la latencia por día con la cantidad de equipos (--scaling)
+//Ejecuta el coordinador sin pausas ni salida por día para 4, 16, 64 y 256 equipos (replicando la
+//tabla de equipos vigente) y muestra latencia y sobrecarga de coordinación promedio por día
+void medir_escalamiento(const OpcionesSimulacion& opciones) {
+    const int tamanos[] = {4, 16, 64, 256};
+    vector<TipoEquipo> base = campamento.equipos;
+    OpcionesSimulacion opciones_medicion = opciones;
+    opciones_medicion.solo_metricas = true;
+    opciones_medicion.silencioso = true;
+    opciones_medicion.escala_tiempo = 0;
+
+    cout << "=== ESCALAMIENTO POR CANTIDAD DE EQUIPOS ===" << endl;
+    cout << "Modo: " << crear_backend(opciones)->descripcion()
+         << ", espera " << (opciones.espera_polling ? "por sondeo" : "eventfd/epoll")
+         << ", " << opciones.dias_simulacion << " días máximo" << endl;
+    cout << "Equipos | Días | Latencia/día (us) | Sobrecarga/día (us) | Latencia/equipo (us)" << endl;
+    for (int n : tamanos) {
+        campamento.equipos = replicar_equipos(base, n);
+        MetricasCoordinador m = coordinador(opciones_medicion);
+        cout << setw(7) << n << " | " << setw(4) << m.dias_medidos << " | " << setw(17) << (long long) m.latencia_dia_us
+             << " | " << setw(19) << (long long) m.sobrecarga_dia_us << " | " << setw(20)
+             << (long long) (m.latencia_dia_us / n) << endl;
+    }
+    campamento.equipos = base;
+}
+
+//Compara el jitter por día sin y con los ajustes de --cpus, --sched y --numa (--jitter)
+//Alterna REPETICIONES_JITTER ejecuciones del coordinador de cada configuración, sin pausas ni salida por
+//día (como --scaling), y junta las series de sobrecarga y despertar de todos sus días
+const int REPETICIONES_JITTER = 5;
+
+void medir_jitter(const OpcionesSimulacion& opciones) {
+    OpcionesSimulacion con_ajustes = opciones;
+    con_ajustes.solo_metricas = true;
+    con_ajustes.silencioso = true;
+    con_ajustes.escala_tiempo = 0;
+    OpcionesSimulacion sin_ajustes = con_ajustes;
+    sin_ajustes.cpus.clear();
+    sin_ajustes.politica.clear();
+    sin_ajustes.numa = false;
+
+    vector<long long> sobrecargas[2], despertares[2];
+    for (int r = 0; r < REPETICIONES_JITTER; ++r) {
+        for (int k = 0; k < 2; ++k) {
+            MetricasCoordinador m = coordinador(k == 0 ? sin_ajustes : con_ajustes);
+            sobrecargas[k].insert(sobrecargas[k].end(), m.sobrecargas_ns.begin(), m.sobrecargas_ns.end());
+            despertares[k].insert(despertares[k].end(), m.despertares_ns.begin(), m.despertares_ns.end());
+        }
+    }
+
+    cout << "=== JITTER POR DÍA SIN Y CON AFINIDAD ===" << endl;
+    cout << "Modo: " << crear_backend(opciones)->descripcion() << ", " << campamento.equipos.size() << " equipos, "
+         << REPETICIONES_JITTER << " ejecuciones de cada configuración (alternadas)" << endl;
+    cout << "Ajustes: " << configurar_afinidad(opciones) << endl;
+    restaurar_afinidad();
+    cout << "Configuración | Días | Sobrecarga: prom. | desv. | p50 | p99 | máx (us) | Despertar: desv. | máx (us)" << endl;
+    const char* nombres[2] = {"sin ajustes", "con ajustes"};
+    for (int k = 0; k < 2; ++k) {
+        ResumenJitter sobrecarga = resumir_jitter(sobrecargas[k]), despertar = resumir_jitter(despertares[k]);
+        cout << setw(13) << nombres[k] << " | " << setw(4) << sobrecargas[k].size() << " | " << setw(17)
+             << (long long) sobrecarga.promedio / 1000 << " | " << setw(5) << (long long) sobrecarga.desviacion / 1000
+             << " | " << setw(3) << sobrecarga.p50 / 1000 << " | " << setw(3) << sobrecarga.p99 / 1000 << " | "
+             << setw(8) << sobrecarga.maximo / 1000 << " | " << setw(16) << (long long) despertar.desviacion / 1000
+             << " | " << setw(8) << despertar.maximo / 1000 << endl;
+    }
+}
+
+//Motor de Eventos Discretos (corrutinas C++20)
+//Cada equipo es una corrutina persistente que espera el inicio del día y luego cada fase en tiempo
+//virtual. Un solo hilo procesa la cola de eventos en orden de tiempo: sin procesos, sin pausas reales
+//y con un marco de corrutina pequeño por equipo, así que escala a cientos de miles de equipos
+
+long long bytes_marcos_eventos = 0;  //Memoria reservada por los marcos de las corrutinas de equipo
+
+//Corrutina de un equipo: arranca en cuanto se crea y queda suspendida hasta que el motor la reanude
+struct TareaEquipo {
+    struct promise_type {
+        TareaEquipo get_return_object() { return TareaEquipo(coroutine_handle<promise_type>::from_promise(*this)); }
+        suspend_never initial_suspend() noexcept { return {}; }
+        suspend_always final_suspend() noexcept { return {}; }  // El marco lo destruye TareaEquipo
+        void return_void() {}
+        void unhandled_exception() { terminate(); }
+        static void* operator new(size_t tamano) {
+            bytes_marcos_eventos += tamano;
+            return ::operator new(tamano);
+        }
+        static void operator delete(void* marco) { ::operator delete(marco); }
+    };
+
+    coroutine_handle<promise_type> handle;
+
+    explicit TareaEquipo(coroutine_handle<promise_type> h) : handle(h) {}
+    TareaEquipo(TareaEquipo&& otra) noexcept : handle(otra.handle) { otra.handle = nullptr; }
+    TareaEquipo(const TareaEquipo&) = delete;
+    ~TareaEquipo() { if (handle) handle.destroy(); }
+};
+
+//Cola de eventos en tiempo virtual (segundos simulados) y estado del día en curso
+struct MotorEventos {
+    struct Evento {
+        long long tiempo;            //Instante simulado en que se reanuda la corrutina
+        uint64_t orden;              //Desempate estable: a igual tiempo, orden de programación
+        coroutine_handle<> handle;
+    };
+
+    vector<Evento> cola;                      //Montículo mínimo por (tiempo, orden)
+    vector<coroutine_handle<>> esperando_dia; //Equipos suspendidos hasta el próximo día
+    long long ahora = 0;                      //Reloj virtual (s)
+    uint64_t orden = 0;
+    long long eventos = 0;                    //Reanudaciones procesadas
+    int dia = 0;                              //Día en curso (CICLO_TERMINAR para terminar)
+    uint64_t semilla = 0;
+    Recursos recursos = {{0, 0, 0, 0}};       //Unidades del día por tipo de recurso
+    vector<int> unidades;                     //Unidades del día por equipo
+    vector<long long> seg_exploracion_total;  //Segundos simulados acumulados por equipo
+    vector<long long> seg_recoleccion_total;
+
+    static bool despues(const Evento& a, const Evento& b) {
+        return a.tiempo > b.tiempo || (a.tiempo == b.tiempo && a.orden > b.orden);
+    }
+
+    void programar(long long tiempo, coroutine_handle<> handle) {
+        cola.push_back({tiempo, orden++, handle});
+        push_heap(cola.begin(), cola.end(), despues);
+    }
+
+    //Reanuda a todos los equipos suspendidos en el inicio del día (para dia = CICLO_TERMINAR, terminan)
+    void lanzar_dia(int nuevo_dia) {
+        dia = nuevo_dia;
+        vector<coroutine_handle<>> listos;
+        listos.swap(esperando_dia);
+        for (coroutine_handle<> h : listos) {
+            ++eventos;
+            h.resume();
+        }
+    }
+
+    //Procesa la cola hasta vaciarla: al volver, todos los equipos terminaron el día
+    void ejecutar() {
+        while (!cola.empty()) {
+            pop_heap(cola.begin(), cola.end(), despues);
+            Evento evento = cola.back();
+            cola.pop_back();
+            ahora = evento.tiempo;
+            ++eventos;
+            evento.handle.resume();
+        }
+    }
+};
+
+//co_await EsperaSimulada{motor, s}: suspende al equipo s segundos de tiempo virtual
+struct EsperaSimulada {
+    MotorEventos& motor;
+    int segundos;
+    bool await_ready() const noexcept { return segundos <= 0; }
+    void await_suspend(coroutine_handle<> h) { motor.programar(motor.ahora + segundos, h); }
+    void await_resume() const noexcept {}
+};
+
+//co_await EsperaDia{motor}: suspende al equipo hasta el próximo día; retorna el día (o CICLO_TERMINAR)
+struct EsperaDia {
+    MotorEventos& motor;
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(coroutine_handle<> h) { motor.esperando_dia.push_back(h); }
+    int await_resume() const noexcept { return motor.dia; }
+};
+
+//Mismo trabajo que trabajar_dia() (mismos flujos del generador), con las pausas como eventos
+TareaEquipo equipo_eventos(MotorEventos& motor, int equipo_id) {
+    while (true) {
+        int dia = co_await EsperaDia{motor};
+        if (dia == CICLO_TERMINAR) co_return;
+
+        GeneradorContador gen_tiempos(motor.semilla, 0, dia, equipo_id, FLUJO_TIEMPOS);
+        int seg_exploracion = gen_tiempos.uniforme(1, 4);
+        co_await EsperaSimulada{motor, seg_exploracion};  // Fase 1: Exploración
+
+        int seg_recoleccion = gen_tiempos.uniforme(1, 4);
+        co_await EsperaSimulada{motor, seg_recoleccion};  // Fase 2: Recolección
+
+        co_await EsperaSimulada{motor, 1};                // Fase 3: Finalización (tiempo fijo)
+
+        int unidades = sortear_unidades(motor.semilla, 0, dia, equipo_id);
+        motor.unidades[equipo_id] = unidades;
+        motor.recursos.cantidad[campamento.equipos[equipo_id].recurso] += unidades;
+        motor.seg_exploracion_total[equipo_id] += seg_exploracion;
+        motor.seg_recoleccion_total[equipo_id] += seg_recoleccion;
+    }
+}
+
+//Métricas de una simulación con el motor de eventos
+struct MetricasEventos {
+    int dias_medidos;     //Días simulados
+    long long eventos;    //Reanudaciones de corrutinas procesadas
+    double segundos;      //Tiempo real de la simulación (sin crear ni destruir corrutinas)
+};
+
+//Simula los días con el motor de eventos en un solo hilo (--des)
+//Misma semilla, mismos resultados por día y mismo resumen que coordinador(); no muestra las fases de cada
+//equipo ni "Iniciando equipos..."
+//El tiempo es solo virtual: --time-scale no aplica
+MetricasEventos simular_eventos(const OpcionesSimulacion& opciones) {
+    const ReglasSupervivencia& reglas = campamento.reglas;
+    int num_equipos = (int) campamento.equipos.size();
+    EstadoSupervivencia estado = {reglas.moral_inicial, 0};
+    bool resumen_final = !opciones.solo_metricas;
+
+    if (resumen_final) mostrar_encabezado(opciones, num_equipos, "corrutinas (eventos discretos, 1 hilo)");
+
+    MotorEventos motor;
+    motor.semilla = opciones.semilla;
+    motor.unidades.assign(num_equipos, 0);
+    motor.seg_exploracion_total.assign(num_equipos, 0);
+    motor.seg_recoleccion_total.assign(num_equipos, 0);
+    motor.cola.reserve(num_equipos);
+    motor.esperando_dia.reserve(num_equipos);
+
+    // Crear las corrutinas: cada una corre hasta esperar el primer día
+    bytes_marcos_eventos = 0;
+    vector<TareaEquipo> equipos;
+    equipos.reserve(num_equipos);
+    for (int i = 0; i < num_equipos; ++i) equipos.push_back(equipo_eventos(motor, i));
+
+    ResumenDia resumen;
+    resumen.pids.assign(num_equipos, 0);  // Sin procesos: los equipos no tienen PID
+    MetricasEventos metricas = {0, 0, 0};
+    long long t_inicio = ahora_ns();
+    for (int dia = 1; ; ++dia) {
+        if (!opciones.silencioso) cout << "=== DÍA " << dia << " DE SUPERVIVENCIA ===" << endl;
+
+        // El día dura lo que tarda el último evento en la cola
+        long long inicio_dia = motor.ahora;
+        motor.recursos = {{0, 0, 0, 0}};
+        motor.lanzar_dia(dia);
+        motor.ejecutar();
+        ++metricas.dias_medidos;
+
+        resumen.dia = dia;
+        resumen.unidades = motor.unidades;
+        resumen.recursos = motor.recursos;
+        resumen.duracion_simulada = (int) (motor.ahora - inicio_dia);
+        resumen.reloj_simulado = motor.ahora;
+        resumen.evaluacion = aplicar_dia(estado, motor.recursos, reglas);
+        resumen.estado = estado;
+        if (!opciones.silencioso) mostrar_dia(resumen);
+
+        FinSimulacion fin;
+        if (simulacion_terminada(estado, dia, opciones.dias_simulacion, reglas, fin)) {
+            if (resumen_final) mostrar_fin(fin, resumen, opciones.dias_simulacion);
+            if (resumen_final && fin == FIN_RESCATE) {
+                cout << "\n██▓▒░ FELICIDADES - MISIÓN CUMPLIDA ░▒▓██" << endl;
+                cout << "Todos los sobrevivientes han sido rescatados exitosamente" << endl;
+            }
+            break;
+        }
+
+        if (!opciones.silencioso) cout << "\n----------------------------------------\n" << endl;
+        motor.ahora += 1;  // Pausa entre días
+    }
+    metricas.segundos = (ahora_ns() - t_inicio) / 1e9;
+    metricas.eventos = motor.eventos;
+
+    // Terminar las corrutinas (salen del bucle y quedan en su suspensión final)
+    motor.lanzar_dia(CICLO_TERMINAR);
+
+    if (resumen_final) {
+        cout << "\nMotor de eventos: " << metricas.eventos << " eventos en " << metricas.segundos * 1000
+             << " ms (" << (long long) (metricas.eventos / max(metricas.segundos, 1e-9)) << " eventos/s), "
+             << bytes_marcos_eventos / num_equipos << " bytes de marco por equipo" << endl;
+        if (num_equipos <= MAX_EQUIPOS_DETALLE) {
+            mostrar_tiempo_simulado(motor.ahora, metricas.dias_medidos,
+                                    motor.seg_exploracion_total, motor.seg_recoleccion_total);
+        } else {
+            cout << "\nTiempo simulado total: " << motor.ahora << " s en " << metricas.dias_medidos << " días" << endl;
+        }
+    }
+    return metricas;
+}
+
+//Modo Batch Monte Carlo
+
+//Resultados acumulados de un conjunto de simulaciones independientes
+struct ResumenBatch {
+    long long fines[3];                   //Conteo por FinSimulacion
+    long long dia_final[MAX_DIAS + 1];    //Distribución del día en que terminó cada corrida
+};
+
+//Ejecuta una simulación completa sin procesos, sin memoria compartida y sin salida por consola
+//Reproduce el bucle de días de coordinador(): todos los equipos sortean resultado y unidades cada día
+//semilla y corrida fijan los flujos aleatorios, por lo que el resultado no depende del hilo que la ejecute
+//dia_final [out] Día en que terminó la simulación
+FinSimulacion simular_corrida(int dias_simulacion, uint64_t semilla, uint64_t corrida, int& dia_final) {
+    const ReglasSupervivencia& reglas = campamento.reglas;
+    EstadoSupervivencia estado = {reglas.moral_inicial, 0};
+    FinSimulacion fin = FIN_LIMITE_TIEMPO;
+    for (int dia = 1; ; ++dia) {
+        Recursos recursos_dia = sortear_dia(semilla, corrida, dia);
+        aplicar_dia(estado, recursos_dia, reglas);
+        if (simulacion_terminada(estado, dia, dias_simulacion, reglas, fin)) {
+            dia_final = dia;
+            return fin;
+        }
+    }
+}
+
+//Igual que simular_corrida() pero grabando cada día en la traza (unidades por equipo, moral y racha)
+//Camino separado para que el modo batch sin --trace no pague el sorteo por equipo ni las escrituras
+FinSimulacion simular_corrida_traza(int dias_simulacion, uint64_t semilla, uint64_t corrida, int& dia_final,
+                                    BloqueTraza& traza) {
+    const ReglasSupervivencia& reglas = campamento.reglas;
+    int num_equipos = (int) campamento.equipos.size();
+    EstadoSupervivencia estado = {reglas.moral_inicial, 0};
+    FinSimulacion fin = FIN_LIMITE_TIEMPO;
+    vector<int> unidades(num_equipos);
+    for (int dia = 1; ; ++dia) {
+        Recursos recursos_dia = {{0, 0, 0, 0}};
+        for (int e = 0; e < num_equipos; ++e) {
+            unidades[e] = sortear_unidades(semilla, corrida, dia, e);
+            recursos_dia.cantidad[campamento.equipos[e].recurso] += unidades[e];
+        }
+        EvaluacionDia evaluacion = aplicar_dia(estado, recursos_dia, reglas);
+        bool terminada = simulacion_terminada(estado, dia, dias_simulacion, reglas, fin);
+        int fila = agregar_dia_traza(traza, (long long) corrida, dia, estado, evaluacion, 0, terminada ? fin : -1);
+        for (int e = 0; e < num_equipos; ++e) traza.celda_equipo(CAMPO_UNIDADES, e, fila) = unidades[e];
+        if (terminada) {
+            dia_final = dia;
+            return fin;
+        }
+    }
+}
+
+//Motor en Lockstep (Structure of Arrays)
+//Mantiene el estado de miles de corridas en arreglos paralelos y aplica cada día con kernels
+//vectoriales: faltantes, penalizaciones (x3/x2/x1/x2), racha de señales y término por máscaras
+
+//Lote de corridas en formato SoA (un elemento por corrida; capacidad múltiplo de 8)
+struct LoteSimulaciones {
+    int capacidad;
+    vector<int32_t> moral, racha;                          //Estado de supervivencia
+    vector<int32_t> recursos[NUM_RECURSOS];                //Recursos totales del día, por tipo
+    vector<int32_t> activo;                                //-1: corrida en curso, 0: terminada (máscara)
+    vector<int32_t> fin, dia_final;                        //FinSimulacion y día de término
+
+    explicit LoteSimulaciones(int n)
+        : capacidad((n + 7) / 8 * 8), moral(capacidad), racha(capacidad),
+          activo(capacidad), fin(capacidad), dia_final(capacidad) {
+        for (int k = 0; k < NUM_RECURSOS; ++k) recursos[k].resize(capacidad);
+    }
+};
+
+//Kernel de un día: actualiza las corridas activas del lote y retorna cuántas siguen activas
+typedef int (*KernelDia)(LoteSimulaciones& lote, int dia, int dias_simulacion, const ReglasSupervivencia& reglas);
+
+//Kernel escalar (respaldo portable): mismo cálculo que aplicar_dia() + simulacion_terminada()
+int kernel_dia_escalar(LoteSimulaciones& lote, int dia, int dias_simulacion, const ReglasSupervivencia& reglas) {
+    int activos = 0;
+    for (int j = 0; j < lote.capacidad; ++j) {
+        if (!lote.activo[j]) continue;
+        int perdida = 0;
+        for (int k = 0; k < NUM_RECURSOS; ++k) {
+            perdida += max(reglas.minimo[k] - lote.recursos[k][j], 0) * reglas.penalizacion[k];
+        }
+        lote.moral[j] = max(lote.moral[j] - perdida, 0);
+        lote.racha[j] = lote.recursos[RECURSO_SENALES][j] >= reglas.minimo[RECURSO_SENALES] ? lote.racha[j] + 1 : 0;
+        if (lote.racha[j] >= reglas.dias_rescate) lote.fin[j] = FIN_RESCATE;
+        else if (lote.moral[j] <= 0) lote.fin[j] = FIN_COLAPSO_MORAL;
+        else if (dia >= dias_simulacion) lote.fin[j] = FIN_LIMITE_TIEMPO;
+        else { ++activos; continue; }
+        lote.dia_final[j] = dia;
+        lote.activo[j] = 0;
+    }
+    return activos;
+}
+
+#ifdef KERNELS_X86
+//Kernel SSE4.1: 4 corridas por instrucción
+__attribute__((target("sse4.1")))
+int kernel_dia_sse41(LoteSimulaciones& lote, int dia, int dias_simulacion, const ReglasSupervivencia& reglas) {
+    const __m128i cero = _mm_setzero_si128(), uno = _mm_set1_epi32(1);
+    __m128i minimo[NUM_RECURSOS], penalizacion[NUM_RECURSOS];
+    for (int k = 0; k < NUM_RECURSOS; ++k) {
+        minimo[k] = _mm_set1_epi32(reglas.minimo[k]);
+        penalizacion[k] = _mm_set1_epi32(reglas.penalizacion[k]);
+    }
+    const __m128i rescate_umbral = _mm_set1_epi32(reglas.dias_rescate - 1);
+    const __m128i limite = _mm_set1_epi32(dia >= dias_simulacion ? -1 : 0);
+    const __m128i v_dia = _mm_set1_epi32(dia);
+    const __m128i c_colapso = _mm_set1_epi32(FIN_COLAPSO_MORAL), c_limite = _mm_set1_epi32(FIN_LIMITE_TIEMPO);
+    int activos = 0;
+    for (int j = 0; j < lote.capacidad; j += 4) {
+        __m128i act = _mm_loadu_si128((const __m128i*) &lote.activo[j]);
+        if (_mm_testz_si128(act, act)) continue; // Las 4 corridas ya terminaron
+        __m128i perdida = cero;
+        for (int k = 0; k < NUM_RECURSOS; ++k) {
+            __m128i cantidad = _mm_loadu_si128((const __m128i*) &lote.recursos[k][j]);
+            __m128i faltante = _mm_max_epi32(_mm_sub_epi32(minimo[k], cantidad), cero);
+            perdida = _mm_add_epi32(perdida, _mm_mullo_epi32(faltante, penalizacion[k]));
+        }
+        __m128i sen = _mm_loadu_si128((const __m128i*) &lote.recursos[RECURSO_SENALES][j]);
+
+        __m128i moral = _mm_loadu_si128((const __m128i*) &lote.moral[j]);
+        __m128i racha = _mm_loadu_si128((const __m128i*) &lote.racha[j]);
+        __m128i moral_n = _mm_max_epi32(_mm_sub_epi32(moral, perdida), cero);
+        __m128i sen_ok = _mm_cmpgt_epi32(minimo[RECURSO_SENALES], sen);  // true si faltan señales
+        __m128i racha_n = _mm_andnot_si128(sen_ok, _mm_add_epi32(racha, uno));
+        _mm_storeu_si128((__m128i*) &lote.moral[j], _mm_blendv_epi8(moral, moral_n, act));
+        _mm_storeu_si128((__m128i*) &lote.racha[j], _mm_blendv_epi8(racha, racha_n, act));
+
+        __m128i rescate = _mm_cmpgt_epi32(racha_n, rescate_umbral);
+        __m128i colapso = _mm_cmpgt_epi32(uno, moral_n);
+        __m128i termina = _mm_and_si128(act, _mm_or_si128(_mm_or_si128(rescate, colapso), limite));
+        __m128i codigo = _mm_blendv_epi8(_mm_blendv_epi8(c_limite, c_colapso, colapso), cero, rescate);
+        __m128i fin = _mm_loadu_si128((const __m128i*) &lote.fin[j]);
+        __m128i dia_final = _mm_loadu_si128((const __m128i*) &lote.dia_final[j]);
+        _mm_storeu_si128((__m128i*) &lote.fin[j], _mm_blendv_epi8(fin, codigo, termina));
+        _mm_storeu_si128((__m128i*) &lote.dia_final[j], _mm_blendv_epi8(dia_final, v_dia, termina));
+        act = _mm_andnot_si128(termina, act);
+        _mm_storeu_si128((__m128i*) &lote.activo[j], act);
+        activos += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(act)));
+    }
+    return activos;
+}
+
+//Kernel AVX2: 8 corridas por instrucción
+__attribute__((target("avx2")))
+int kernel_dia_avx2(LoteSimulaciones& lote, int dia, int dias_simulacion, const ReglasSupervivencia& reglas) {
+    const __m256i cero = _mm256_setzero_si256(), uno = _mm256_set1_epi32(1);
+    __m256i minimo[NUM_RECURSOS], penalizacion[NUM_RECURSOS];
+    for (int k = 0; k < NUM_RECURSOS; ++k) {
+        minimo[k] = _mm256_set1_epi32(reglas.minimo[k]);
+        penalizacion[k] = _mm256_set1_epi32(reglas.penalizacion[k]);
+    }
+    const __m256i rescate_umbral = _mm256_set1_epi32(reglas.dias_rescate - 1);
+    const __m256i limite = _mm256_set1_epi32(dia >= dias_simulacion ? -1 : 0);
+    const __m256i v_dia = _mm256_set1_epi32(dia);
+    const __m256i c_colapso = _mm256_set1_epi32(FIN_COLAPSO_MORAL), c_limite = _mm256_set1_epi32(FIN_LIMITE_TIEMPO);
+    int activos = 0;
+    for (int j = 0; j < lote.capacidad; j += 8) {
+        __m256i act = _mm256_loadu_si256((const __m256i*) &lote.activo[j]);
+        if (_mm256_testz_si256(act, act)) continue; // Las 8 corridas ya terminaron
+        __m256i perdida = cero;
+        for (int k = 0; k < NUM_RECURSOS; ++k) {
+            __m256i cantidad = _mm256_loadu_si256((const __m256i*) &lote.recursos[k][j]);
+            __m256i faltante = _mm256_max_epi32(_mm256_sub_epi32(minimo[k], cantidad), cero);
+            perdida = _mm256_add_epi32(perdida, _mm256_mullo_epi32(faltante, penalizacion[k]));
+        }
+        __m256i sen = _mm256_loadu_si256((const __m256i*) &lote.recursos[RECURSO_SENALES][j]);
+
+        __m256i moral = _mm256_loadu_si256((const __m256i*) &lote.moral[j]);
+        __m256i racha = _mm256_loadu_si256((const __m256i*) &lote.racha[j]);
+        __m256i moral_n = _mm256_max_epi32(_mm256_sub_epi32(moral, perdida), cero);
+        __m256i sen_ok = _mm256_cmpgt_epi32(minimo[RECURSO_SENALES], sen);  // true si faltan señales
+        __m256i racha_n = _mm256_andnot_si256(sen_ok, _mm256_add_epi32(racha, uno));
+        _mm256_storeu_si256((__m256i*) &lote.moral[j], _mm256_blendv_epi8(moral, moral_n, act));
+        _mm256_storeu_si256((__m256i*) &lote.racha[j], _mm256_blendv_epi8(racha, racha_n, act));
+
+        __m256i rescate = _mm256_cmpgt_epi32(racha_n, rescate_umbral);
+        __m256i colapso = _mm256_cmpgt_epi32(uno, moral_n);
+        __m256i termina = _mm256_and_si256(act, _mm256_or_si256(_mm256_or_si256(rescate, colapso), limite));
+        __m256i codigo = _mm256_blendv_epi8(_mm256_blendv_epi8(c_limite, c_colapso, colapso), cero, rescate);
+        __m256i fin = _mm256_loadu_si256((const __m256i*) &lote.fin[j]);
+        __m256i dia_final = _mm256_loadu_si256((const __m256i*) &lote.dia_final[j]);
+        _mm256_storeu_si256((__m256i*) &lote.fin[j], _mm256_blendv_epi8(fin, codigo, termina));
+        _mm256_storeu_si256((__m256i*) &lote.dia_final[j], _mm256_blendv_epi8(dia_final, v_dia, termina));
+        act = _mm256_andnot_si256(termina, act);
+        _mm256_storeu_si256((__m256i*) &lote.activo[j], act);
+        activos += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(act)));
+    }
+    return activos;
+}
+#endif
+
+//Elige el kernel del motor lockstep según la preferencia y lo que soporta la CPU en tiempo de ejecución
+//nombre [out] Kernel efectivamente elegido
+KernelDia seleccionar_kernel(const string& preferencia, string& nombre) {
+#ifdef KERNELS_X86
+    __builtin_cpu_init();
+    bool avx2 = __builtin_cpu_supports("avx2");
+    bool sse41 = __builtin_cpu_supports("sse4.1");
+    if ((preferencia == "auto" || preferencia == "avx2") && avx2) { nombre = "avx2"; return kernel_dia_avx2; }
+    if ((preferencia == "auto" || preferencia == "avx2" || preferencia == "sse41") && sse41) {
+        nombre = "sse41"; return kernel_dia_sse41;
+    }
+#else
+    (void) preferencia;
+#endif
+    nombre = "escalar";
+    return kernel_dia_escalar;
+}
+
+//Simula en lockstep las corridas [corrida_base, corrida_base + n) y acumula sus resultados
+//Los recursos se sortean por corrida con el mismo generador que simular_corrida(), así que
+//el resultado es idéntico al del camino escalar; solo la evaluación del día es vectorial
+void simular_lote(LoteSimulaciones& lote, int n, long long corrida_base, int dias_simulacion,
+                  uint64_t semilla, KernelDia kernel, ResumenBatch& resumen) {
+    const ReglasSupervivencia& reglas = campamento.reglas;
+    for (int j = 0; j < lote.capacidad; ++j) {
+        lote.moral[j] = reglas.moral_inicial;
+        lote.racha[j] = 0;
+        lote.activo[j] = j < n ? -1 : 0;  // El relleno hasta múltiplo de 8 nace terminado
+        lote.fin[j] = FIN_LIMITE_TIEMPO;
+        lote.dia_final[j] = 0;
+    }
+    int activos = n;
+    for (int dia = 1; activos > 0; ++dia) {
+        for (int j = 0; j < n; ++j) {
+            if (!lote.activo[j]) continue;
+            Recursos recursos_dia = sortear_dia(semilla, (uint64_t) (corrida_base + j), dia);
+            for (int k = 0; k < NUM_RECURSOS; ++k) lote.recursos[k][j] = recursos_dia.cantidad[k];
+        }
+        activos = kernel(lote, dia, dias_simulacion, reglas);
+    }
+    for (int j = 0; j < n; ++j) {
+        ++resumen.fines[lote.fin[j]];
+        ++resumen.dia_final[lote.dia_final[j]];
+    }
+}
+
+//Puntos de Control (--checkpoint F, --resume)
+//El estado de una ejecución larga (modo batch o flujo continuo) es pequeño y de tamaño fijo: se guarda
+//periódicamente en un archivo mapeado en memoria. Como el generador está basado en contador, su
+//posición queda fijada por la corrida (o escenario y día) ya alcanzada: no hay estado aleatorio aparte.
+//El archivo tiene dos ranuras: cada guardado escribe la más antigua, su suma de verificación y al final su
+//número de secuencia, así un proceso terminado a mitad de un guardado deja intacta la ranura anterior.
+//--resume retoma desde la ranura válida más reciente y produce el mismo resultado que una ejecución sin
+//interrupciones
+
+const char MAGIA_PUNTO_CONTROL[8] = {'L', 'A', 'B', '2', 'C', 'K', 'P', 0};
+const uint32_t VERSION_PUNTO_CONTROL = 1;
+const long long CORRIDAS_ENTRE_PUNTOS = 1 << 20;  //Corridas entre guardados del modo batch sin --checkpoint-every
+const long long DIAS_ENTRE_PUNTOS = 100000;       //Días entre guardados del flujo continuo sin --checkpoint-every
+
+//Ejecución a la que pertenece un punto de control
+enum ModoPuntoControl {
+    PUNTO_CONTROL_BATCH = 1,
+    PUNTO_CONTROL_FLUJO = 2
+};
+
+//Cabecera del archivo de punto de control, seguida de dos ranuras de tamano_estado bytes
+struct CabeceraPuntoControl {
+    char magia[8];
+    uint32_t version;
+    uint32_t modo;            //ModoPuntoControl
+    uint64_t semilla;         //Semilla global de la ejecución
+    uint64_t firma;           //Huella de las reglas, los equipos y las opciones que fijan el resultado
+    uint64_t tamano_estado;   //Bytes de cada ranura
+    uint64_t secuencia[2];    //Número de guardado de cada ranura (0: vacía); se escribe al final
+    uint64_t suma[2];         //Suma de verificación del contenido de cada ranura
+};
+
+//Punto de control abierto y mapeado
+struct PuntoControl {
+    int fd = -1;
+    CabeceraPuntoControl* cabecera = nullptr;
+    char* ranuras = nullptr;
+    size_t tamano_mapa = 0;
+};
+
+//Suma de verificación de un bloque de bytes (mezclar64 por palabra)
+uint64_t suma_punto_control(const char* datos, size_t tamano) {
+    uint64_t suma = tamano;
+    for (size_t i = 0; i < tamano; i += 8) {
+        uint64_t palabra = 0;
+        memcpy(&palabra, datos + i, min((size_t) 8, tamano - i));
+        suma = mezclar64(suma ^ palabra);
+    }
+    return suma;
+}
+
+//Huella de la configuración vigente (reglas y equipos) combinada con los parámetros de la ejecución
+uint64_t firma_ejecucion(ModoPuntoControl modo, long long total, int dias_simulacion) {
+    const ReglasSupervivencia& r = campamento.reglas;
+    uint64_t firma = mezclar64(modo ^ mezclar64((uint64_t) total ^ mezclar64((uint64_t) dias_simulacion)));
+    int k; fo(k, NUM_RECURSOS) firma = mezclar64(firma ^ ((uint64_t) (uint32_t) r.minimo[k] << 32 | (uint32_t) r.penalizacion[k]));
+    firma = mezclar64(firma ^ ((uint64_t) (uint32_t) r.moral_inicial << 32 | (uint32_t) r.dias_rescate));
+    for (const TipoEquipo& equipo : campamento.equipos) {
+        firma = mezclar64(firma ^ ((uint64_t) equipo.recurso << 48 | (uint64_t) (uint32_t) equipo.base_min << 24 |
+                                   (uint32_t) equipo.base_max));
+    }
+    return firma;
+}
+
+//Lee la semilla guardada en un punto de control (--resume sin --seed)
+//Retorna false si el archivo no existe o no es un punto de control
+bool semilla_punto_control(const string& ruta, uint64_t& semilla) {
+    int fd = open(ruta.c_str(), O_RDONLY);
+    if (fd == -1) return false;
+    CabeceraPuntoControl cabecera;
+    bool valido = pread(fd, &cabecera, sizeof(cabecera), 0) == (ssize_t) sizeof(cabecera) &&
+                  memcmp(cabecera.magia, MAGIA_PUNTO_CONTROL, sizeof(cabecera.magia)) == 0;
+    close(fd);
+    if (valido) semilla = cabecera.semilla;
+    return valido;
+}
+
+//Abre (o crea) el punto de control de opciones.archivo_punto_control y lo mapea
+//Con opciones.reanudar copia en estado la ranura válida más reciente y retorna true; si no, deja el
+//archivo vacío con la cabecera de esta ejecución y retorna false. Termina con un error si el archivo no
+//corresponde a la misma ejecución (modo, semilla, configuración u opciones distintas)
+bool abrir_punto_control(const OpcionesSimulacion& opciones, ModoPuntoControl modo, uint64_t firma,
+                         size_t tamano_estado, PuntoControl& pc, void* estado) {
+    pc.tamano_mapa = sizeof(CabeceraPuntoControl) + 2 * tamano_estado;
+    pc.fd = open(opciones.archivo_punto_control.c_str(), O_RDWR | (opciones.reanudar ? 0 : O_CREAT | O_TRUNC), 0644);
+    if (pc.fd == -1) {
+        perror("open punto de control");
+        exit(1);
+    }
+    struct stat st;
+    if (fstat(pc.fd, &st) == -1) {
+        perror("fstat punto de control");
+        exit(1);
+    }
+    if (opciones.reanudar && (size_t) st.st_size != pc.tamano_mapa) {
+        cout << "Error: " << opciones.archivo_punto_control << " no es un punto de control de esta ejecución (tamaño distinto)" << endl;
+        exit(1);
+    }
+    if (!opciones.reanudar && ftruncate(pc.fd, (off_t) pc.tamano_mapa) == -1) {
+        perror("ftruncate punto de control");
+        exit(1);
+    }
+    void* mapa = mmap(NULL, pc.tamano_mapa, PROT_READ | PROT_WRITE, MAP_SHARED, pc.fd, 0);
+    if (mapa == MAP_FAILED) {
+        perror("mmap punto de control");
+        exit(1);
+    }
+    pc.cabecera = (CabeceraPuntoControl*) mapa;
+    pc.ranuras = (char*) mapa + sizeof(CabeceraPuntoControl);
+    CabeceraPuntoControl& c = *pc.cabecera;
+
+    if (!opciones.reanudar) {
+        memcpy(c.magia, MAGIA_PUNTO_CONTROL, sizeof(c.magia));
+        c.version = VERSION_PUNTO_CONTROL;
+        c.modo = modo;
+        c.semilla = opciones.semilla;
+        c.firma = firma;
+        c.tamano_estado = tamano_estado;
+        return false;
+    }
+
+    string problema;
+    if (memcmp(c.magia, MAGIA_PUNTO_CONTROL, sizeof(c.magia)) != 0 || c.version != VERSION_PUNTO_CONTROL) problema = "formato desconocido";
+    else if (c.modo != (uint32_t) modo) problema = "es de otro modo (batch o flujo continuo)";
+    else if (c.semilla != opciones.semilla) problema = "la semilla es distinta";
+    else if (c.firma != firma || c.tamano_estado != tamano_estado) problema = "la configuración o las opciones son distintas";
+    int ranura = -1;
+    int r; fo(r, 2) {
+        if (c.secuencia[r] == 0 || suma_punto_control(pc.ranuras + r * tamano_estado, tamano_estado) != c.suma[r]) continue;
+        if (ranura == -1 || c.secuencia[r] > c.secuencia[ranura]) ranura = r;
+    }
+    if (problema.empty() && ranura == -1) problema = "no tiene ningún guardado válido";
+    if (!problema.empty()) {
+        cout << "Error: no se puede reanudar desde " << opciones.archivo_punto_control << ": " << problema << endl;
+        exit(1);
+    }
+    memcpy(estado, pc.ranuras + ranura * tamano_estado, tamano_estado);
+    return true;
+}
+
+//Guarda estado en la ranura más antigua; el número de secuencia se publica después del contenido
+void guardar_punto_control(PuntoControl& pc, const void* estado) {
+    CabeceraPuntoControl& c = *pc.cabecera;
+    int ranura = c.secuencia[0] <= c.secuencia[1] ? 0 : 1;
+    char* destino = pc.ranuras + ranura * c.tamano_estado;
+    __atomic_store_n(&c.secuencia[ranura], 0, __ATOMIC_RELEASE);  // Ranura inválida mientras se escribe
+    memcpy(destino, estado, c.tamano_estado);
+    c.suma[ranura] = suma_punto_control(destino, c.tamano_estado);
+    __atomic_store_n(&c.secuencia[ranura], max(c.secuencia[0], c.secuencia[1]) + 1, __ATOMIC_RELEASE);
+    msync(c.magia, pc.tamano_mapa, MS_ASYNC);  // El kernel lo escribe a disco sin bloquear la simulación
+}
+
+void cerrar_punto_control(PuntoControl& pc) {
+    if (pc.cabecera == nullptr) return;
+    msync(pc.cabecera, pc.tamano_mapa, MS_SYNC);
+    munmap(pc.cabecera, pc.tamano_mapa);
+    close(pc.fd);
+    pc.cabecera = nullptr;
+}
+
+//Reparte [0, total) en bloques de tamaño bloque entre hilos trabajadores; trabajo(h, desde, hasta)
+//recibe el índice del hilo que lo ejecuta (para acumular en su contexto local sin sincronizar)
+//Con --backend pool cada bloque es una tarea del pool con robo de trabajo; si no, hilos fijos que
+//reservan bloques con un contador atómico
+void repartir_bloques(const OpcionesSimulacion& opciones, int hilos, long long total, long long bloque,
+                      const function<void(int, long long, long long)>& trabajo) {
+    if (opciones.backend == "pool") {
+        PoolRobo pool(hilos);
+        for (long long desde = 0; desde < total; desde += bloque) {
+            long long hasta = min(desde + bloque, total);
+            pool.enviar([&trabajo, desde, hasta](int w) { trabajo(w, desde, hasta); });
+        }
+        pool.esperar();
+        return;
+    }
+    atomic<long long> siguiente(0);
+    vector<thread> pool;
+    for (int h = 0; h < hilos; ++h) {
+        pool.emplace_back([&, h]() {
+            while (true) {
+                long long desde = siguiente.fetch_add(bloque);
+                if (desde >= total) break;
+                trabajo(h, desde, min(desde + bloque, total));
+            }
+        });
+    }
+    for (thread& t : pool) t.join();
+}
+
+//Estado del modo batch que se guarda en el punto de control
+struct PuntoControlBatch {
+    long long corridas_hechas;  //Las corridas [0, corridas_hechas) ya están en total
+    ResumenBatch total;
+};
+
+//Ejecuta opciones.corridas simulaciones repartidas en un pool de hilos
+//Cada hilo toma bloques de corridas (repartir_bloques) y acumula en un resumen local;
+//los resúmenes se suman al final
+//Con --checkpoint las corridas se simulan por tramos y tras cada tramo se guarda el resumen acumulado;
+//con --resume se parte del último guardado
+//hilos [out] Hilos usados; nombre_kernel [out] Kernel del motor lockstep
+//corridas_reanudadas [out] Corridas que ya venían en el punto de control (0 sin --resume)
+ResumenBatch ejecutar_batch(const OpcionesSimulacion& opciones, int& hilos, string& nombre_kernel,
+                            long long* corridas_reanudadas = nullptr) {
+    hilos = opciones.hilos > 0 ? opciones.hilos : (int) max(1u, thread::hardware_concurrency());
+    // Corridas reservadas por hilo en cada toma del contador (en lockstep, el tamaño del lote SoA)
+    const long long BLOQUE = opciones.lockstep ? 4096 : 256;
+    KernelDia kernel = seleccionar_kernel(opciones.simd, nombre_kernel);
+    vector<ResumenBatch> resumenes(hilos);
+    // Traza opcional (--trace): cada hilo llena sus propios bloques y los agrega al archivo común
+    int fd_traza = opciones.archivo_traza.empty() ? -1 : crear_traza(opciones.archivo_traza, opciones, 1);
+
+    // Contexto de cada hilo: su resumen, su lote SoA y su bloque de traza
+    vector<unique_ptr<LoteSimulaciones>> lotes;
+    vector<unique_ptr<BloqueTraza>> trazas;
+    for (int h = 0; h < hilos; ++h) {
+        memset(&resumenes[h], 0, sizeof(resumenes[h]));
+        lotes.emplace_back(new LoteSimulaciones(opciones.lockstep ? (int) BLOQUE : 0));
+        trazas.emplace_back(new BloqueTraza(fd_traza, fd_traza == -1 ? 0 : (int) campamento.equipos.size(), 1));
+    }
+
+    // Simula las corridas [desde, hasta) con el contexto del hilo h
+    auto simular_bloque = [&](int h, long long desde, long long hasta) {
+        ResumenBatch& local = resumenes[h];
+        if (opciones.lockstep) {
+            simular_lote(*lotes[h], (int) (hasta - desde), desde, opciones.dias_simulacion,
+                         opciones.semilla, kernel, local);
+            return;
+        }
+        for (long long c = desde; c < hasta; ++c) {
+            int dia_final;
+            FinSimulacion fin = fd_traza == -1
+                ? simular_corrida(opciones.dias_simulacion, opciones.semilla, (uint64_t) c, dia_final)
+                : simular_corrida_traza(opciones.dias_simulacion, opciones.semilla, (uint64_t) c, dia_final, *trazas[h]);
+            ++local.fines[fin];
+            ++local.dia_final[dia_final];
+        }
+    };
+
+    // Punto de control opcional: guardado.total parte del resumen guardado (o vacío) y se le suman los hilos
+    PuntoControlBatch reanudado, guardado;
+    memset(&reanudado, 0, sizeof(reanudado));
+    PuntoControl pc;
+    long long tramo = opciones.corridas;
+    if (!opciones.archivo_punto_control.empty()) {
+        abrir_punto_control(opciones, PUNTO_CONTROL_BATCH, firma_ejecucion(PUNTO_CONTROL_BATCH, opciones.corridas, opciones.dias_simulacion),
+                            sizeof(reanudado), pc, &reanudado);
+        tramo = opciones.puntos_cada > 0 ? opciones.puntos_cada : CORRIDAS_ENTRE_PUNTOS;
+    }
+    if (corridas_reanudadas != nullptr) *corridas_reanudadas = reanudado.corridas_hechas;
+    // Sumar resúmenes de todos los hilos al resumen reanudado
+    auto sumar_resumenes = [&]() {
+        ResumenBatch total = reanudado.total;
+        for (const ResumenBatch& r : resumenes) {
+            int k; fo(k, 3) total.fines[k] += r.fines[k];
+            Fo(k, 1, MAX_DIAS + 1) total.dia_final[k] += r.dia_final[k];
+        }
+        return total;
+    };
+
+    for (long long inicio = reanudado.corridas_hechas; inicio < opciones.corridas; inicio += tramo) {
+        long long fin = min(inicio + tramo, opciones.corridas);
+        repartir_bloques(opciones, hilos, fin - inicio, BLOQUE, [&](int h, long long desde, long long hasta) {
+            simular_bloque(h, inicio + desde, inicio + hasta);
+        });
+        if (pc.cabecera != nullptr) {
+            guardado.corridas_hechas = fin;
+            guardado.total = sumar_resumenes();
+            guardar_punto_control(pc, &guardado);
+        }
+    }
+    cerrar_punto_control(pc);
+    if (fd_traza != -1) {
+        for (unique_ptr<BloqueTraza>& traza : trazas) vaciar_bloque_traza(*traza);
+    }
+    if (fd_traza != -1) close(fd_traza);
+    return sumar_resumenes();
+}
+
+//Modo batch (--runs): ejecuta las corridas e imprime las tasas de cada resultado
+void batch_monte_carlo(const OpcionesSimulacion& opciones) {
+    int hilos;
+    string nombre_kernel;
+    long long t_inicio = ahora_ns();
+    long long reanudadas;
+    ResumenBatch total = ejecutar_batch(opciones, hilos, nombre_kernel, &reanudadas);
+    double segundos = (ahora_ns() - t_inicio) / 1e9;
+
+    double n = (double) opciones.corridas;
+    const char* nombres_fin[3] = {"Rescate exitoso", "Colapso de moral", "Límite de tiempo"};
+    cout << "=== MODO BATCH MONTE CARLO ===" << endl;
+    cout << "Corridas: " << opciones.corridas << ", hilos: " << hilos
+         << ", días máximos: " << opciones.dias_simulacion << ", semilla: " << opciones.semilla << endl;
+    cout << "Motor: " << (opciones.lockstep ? "lockstep SoA (kernel " + nombre_kernel + ")" : "escalar por corrida") << endl;
+    if (reanudadas > 0) cout << "Reanudado desde " << opciones.archivo_punto_control << ": " << reanudadas << " corridas ya hechas" << endl;
+    cout << "Tiempo: " << segundos << " s (" << (long long) ((n - reanudadas) / max(segundos, 1e-9)) << " corridas/s)" << endl << endl;
+    int k; fo(k, 3) {
+        double p = total.fines[k] / n;
+        double ic = 1.96 * sqrt(p * (1 - p) / n);  // Intervalo de confianza del 95% (aproximación normal)
+        cout << "[i] " << nombres_fin[k] << ": " << total.fines[k] << " (" << 100 * p
+             << "% ± " << 100 * ic << "%)" << endl;
+    }
+    cout << "\nDistribución del día final:" << endl;
+    Fo(k, 1, opciones.dias_simulacion + 1) {
+        if (total.dia_final[k] == 0) continue;
+        double p = total.dia_final[k] / n;
+        cout << "  Día " << (k < 10 ? " " : "") << k << ": " << 100 * p << "% "
+             << string((size_t) (p * 50 + 0.5), '#') << endl;
+    }
+}
+
+//Solucionador Exacto (cadena de Markov)
+//El resultado de un día solo depende de sorteos independientes por equipo: el nivel de éxito de
+//generar_resultado() (el desplazamiento por día y equipo es una permutación de 1..100, así que no
+//cambia las probabilidades), las unidades base y el bonus de calcular_unidades(). El estado de
+//supervivencia es (moral, senales_consecutivas, día), por lo que las probabilidades exactas de cada
+//término salen de propagar la distribución sobre ese espacio de estados día a día
+
+//Distribución exacta de las unidades de un equipo en un día (índice: unidades)
+vector<double> distribucion_unidades(const TipoEquipo& equipo) {
+    int bases = equipo.base_max - equipo.base_min + 1;
+    vector<double> dist(equipo.base_max + 3, 0.0);
+    // Porcentaje de éxito: 30% -> 100; 50% -> uniforme en [50, 80]; 20% -> uniforme en [5, 29]
+    vector<pair<int, double>> porcentajes = {{100, 0.30}};
+    for (int p = 50; p <= 80; ++p) porcentajes.push_back({p, 0.50 / 31});
+    for (int p = 5; p <= 29; ++p) porcentajes.push_back({p, 0.20 / 25});
+    for (const pair<int, double>& porcentaje : porcentajes) {
+        for (int base = equipo.base_min; base <= equipo.base_max; ++base) {
+            int unidades = base * porcentaje.first / 100;
+            for (int bonus = 0; bonus <= 2; ++bonus) dist[unidades + bonus] += porcentaje.second / bases / 3;
+        }
+    }
+    return dist;
+}
+
+//Convolución de dos distribuciones de enteros no negativos (suma de variables independientes)
+vector<double> convolucionar(const vector<double>& a, const vector<double>& b) {
+    vector<double> c(a.size() + b.size() - 1, 0.0);
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i] == 0) continue;
+        for (size_t j = 0; j < b.size(); ++j) c[i + j] += a[i] * b[j];
+    }
+    return c;
+}
+
+//Probabilidades exactas de término y distribución del día final
+struct ResultadoExacto {
+    double fines[3];                  //Probabilidad de cada FinSimulacion
+    double dia_final[MAX_DIAS + 1];   //Probabilidad de terminar en cada día
+    long long estados;                //Estados (moral, racha, día) con probabilidad no nula recorridos
+};
+
+//Resuelve la cadena de Markov de la simulación para dias_simulacion días con la configuración vigente
+ResultadoExacto resolver_exacto(int dias_simulacion) {
+    const ReglasSupervivencia& reglas = campamento.reglas;
+    const int M = reglas.moral_inicial, R = reglas.dias_rescate;
+
+    // Unidades totales por tipo de recurso: convolución de las distribuciones de sus equipos
+    vector<double> total_recurso[NUM_RECURSOS];
+    for (int k = 0; k < NUM_RECURSOS; ++k) total_recurso[k] = {1.0};
+    for (const TipoEquipo& equipo : campamento.equipos) {
+        total_recurso[equipo.recurso] = convolucionar(total_recurso[equipo.recurso], distribucion_unidades(equipo));
+    }
+
+    // Distribución conjunta de (moral perdida, señales suficientes) de un día; la pérdida se acota en M
+    // (perder M o más lleva la moral a 0 igual). Los recursos son independientes entre sí
+    vector<double> perdida = {1.0};  // Pérdida por los recursos distintos de señales
+    for (int k = 0; k < NUM_RECURSOS; ++k) {
+        if (k == RECURSO_SENALES) continue;
+        vector<double> perdida_k(M + 1, 0.0);
+        for (size_t u = 0; u < total_recurso[k].size(); ++u) {
+            perdida_k[min(max(reglas.minimo[k] - (int) u, 0) * reglas.penalizacion[k], M)] += total_recurso[k][u];
+        }
+        perdida = convolucionar(perdida, perdida_k);
+        for (size_t p = M + 1; p < perdida.size(); ++p) perdida[M] += perdida[p];
+        perdida.resize(M + 1);
+    }
+    vector<double> transicion[2] = {vector<double>(M + 1, 0.0), vector<double>(M + 1, 0.0)};  // [señales ok][pérdida]
+    const vector<double>& senales = total_recurso[RECURSO_SENALES];
+    for (size_t u = 0; u < senales.size(); ++u) {
+        int ok = (int) u >= reglas.minimo[RECURSO_SENALES];
+        int perdida_senales = max(reglas.minimo[RECURSO_SENALES] - (int) u, 0) * reglas.penalizacion[RECURSO_SENALES];
+        for (int p = 0; p <= M; ++p) transicion[ok][min(p + perdida_senales, M)] += senales[u] * perdida[p];
+    }
+
+    // Propagación día a día de la distribución sobre (moral 1..M, racha 0..R-1), mismo orden de
+    // verificación que simulacion_terminada(): rescate, colapso y límite de tiempo
+    ResultadoExacto resultado;
+    memset(&resultado, 0, sizeof(resultado));
+    vector<double> actual((size_t) (M + 1) * R, 0.0), siguiente_dia((size_t) (M + 1) * R, 0.0);
+    actual[(size_t) M * R + 0] = 1.0;
+    for (int dia = 1; dia <= dias_simulacion; ++dia) {
+        fill(siguiente_dia.begin(), siguiente_dia.end(), 0.0);
+        for (int moral = 1; moral <= M; ++moral) {
+            for (int racha = 0; racha < R; ++racha) {
+                double masa = actual[(size_t) moral * R + racha];
+                if (masa == 0) continue;
+                ++resultado.estados;
+                for (int ok = 0; ok <= 1; ++ok) {
+                    int nueva_racha = ok ? racha + 1 : 0;
+                    for (int p = 0; p <= M; ++p) {
+                        double q = masa * transicion[ok][p];
+                        if (q == 0) continue;
+                        int nueva_moral = max(moral - p, 0);
+                        int fin = -1;
+                        if (nueva_racha >= R) fin = FIN_RESCATE;
+                        else if (nueva_moral <= 0) fin = FIN_COLAPSO_MORAL;
+                        else if (dia >= dias_simulacion) fin = FIN_LIMITE_TIEMPO;
+                        if (fin >= 0) {
+                            resultado.fines[fin] += q;
+                            resultado.dia_final[dia] += q;
+                        } else {
+                            siguiente_dia[(size_t) nueva_moral * R + nueva_racha] += q;
+                        }
+                    }
+                }
+            }
+        }
+        actual.swap(siguiente_dia);
+    }
+    return resultado;
+}
+
+//Modo analítico (--exact): probabilidades exactas en milisegundos
+//Con --runs N además ejecuta N corridas muestreadas y contrasta cada probabilidad con su estimación:
+//z = (estimada - exacta) / error estándar; |z| < 4 es consistente con el modelo exacto
+void modo_exacto(const OpcionesSimulacion& opciones) {
+    long long t_inicio = ahora_ns();
+    ResultadoExacto exacto = resolver_exacto(opciones.dias_simulacion);
+    double ms = (ahora_ns() - t_inicio) / 1e6;
+
+    const char* nombres_fin[3] = {"Rescate exitoso", "Colapso de moral", "Límite de tiempo"};
+    cout << "=== SOLUCIONADOR EXACTO (CADENA DE MARKOV) ===" << endl;
+    cout << "Días máximos: " << opciones.dias_simulacion << ", equipos: " << campamento.equipos.size()
+         << ", estados recorridos: " << exacto.estados << endl;
+    cout << "Tiempo: " << ms << " ms" << endl << endl;
+    int k; fo(k, 3) {
+        cout << "[i] " << nombres_fin[k] << ": " << 100 * exacto.fines[k] << "%" << endl;
+    }
+    cout << "\nDistribución del día final:" << endl;
+    Fo(k, 1, opciones.dias_simulacion + 1) {
+        double p = exacto.dia_final[k];
+        if (p == 0) continue;
+        cout << "  Día " << (k < 10 ? " " : "") << k << ": " << 100 * p << "% "
+             << string((size_t) (p * 50 + 0.5), '#') << endl;
+    }
+    if (opciones.corridas <= 0) return;
+
+    // Verificación cruzada contra corridas muestreadas con el generador real
+    int hilos;
+    string nombre_kernel;
+    t_inicio = ahora_ns();
+    ResumenBatch muestreo = ejecutar_batch(opciones, hilos, nombre_kernel);
+    double segundos = (ahora_ns() - t_inicio) / 1e9;
+    double n = (double) opciones.corridas;
+    cout << "\nVERIFICACIÓN CRUZADA: " << opciones.corridas << " corridas muestreadas (semilla "
+         << opciones.semilla << ", " << segundos << " s)" << endl;
+    double z_max = 0;
+    fo(k, 3) {
+        double p = exacto.fines[k], estimada = muestreo.fines[k] / n;
+        double z = p > 0 && p < 1 ? (estimada - p) / sqrt(p * (1 - p) / n) : 0;
+        z_max = max(z_max, fabs(z));
+        cout << "[" << (fabs(z) < 4 ? "✓" : "✖") << "] " << nombres_fin[k] << ": exacta " << 100 * p
+             << "%, muestreada " << 100 * estimada << "% (z = " << z << ")" << endl;
+    }
+    Fo(k, 1, opciones.dias_simulacion + 1) {
+        double p = exacto.dia_final[k], estimada = muestreo.dia_final[k] / n;
+        if (p > 0 && p < 1) z_max = max(z_max, fabs((estimada - p) / sqrt(p * (1 - p) / n)));
+    }
+    cout << "Máximo |z| (términos y días finales): " << z_max
+         << (z_max < 4 ? " - el muestreo concuerda con el modelo exacto" : " - DISCREPANCIA con el modelo exacto") << endl;
+}
+
+//Estimadores de Varianza Reducida (--estimator)
+//Para términos raros (colapso con reglas holgadas, rescate con dias_rescate alto) el muestreo simple
+//necesita muchísimas corridas. Estos estimadores reutilizan el generador basado en contador:
+//  antitetico:   pares de corridas con sorteos reflejados (mismo número de corrida). En este modelo no
+//                reduce la varianza de forma apreciable: cada término es un indicador 0/1 con probabilidad
+//                p, y dos indicadores no pueden correlacionarse por debajo de -p/(1-p), así que el factor
+//                no pasa de ~1.1x con p ~ 0.1 (reflejar dentro de cada nivel de éxito tampoco cambia eso)
+//  importancia:  niveles de éxito sorteados con probabilidades inclinadas hacia el término buscado,
+//                cada corrida pesa su razón de verosimilitud
+//  crn:          la misma corrida con la configuración vigente y con una variante (--variant F):
+//                números aleatorios comunes para estimar la diferencia entre ambas
+//Todos informan intervalos de confianza del 95% y el factor de reducción de varianza frente al
+//muestreo simple con el mismo número de corridas
+
+const int NIVELES_EXITO = 3;  //Niveles de generar_resultado(): éxito total, parcial y fracaso
+const double PROB_NIVEL[NIVELES_EXITO] = {0.30, 0.50, 0.20};
+
+//Corrida con reglas explícitas y sorteos opcionalmente antitéticos (mismos flujos que simular_corrida)
+FinSimulacion simular_corrida_reglas(int dias_simulacion, uint64_t semilla, uint64_t corrida,
+                                     const ReglasSupervivencia& reglas, bool antitetico) {
+    EstadoSupervivencia estado = {reglas.moral_inicial, 0};
+    FinSimulacion fin = FIN_LIMITE_TIEMPO;
+    for (int dia = 1; ; ++dia) {
+        aplicar_dia(estado, sortear_dia(semilla, corrida, dia, antitetico), reglas);
+        if (simulacion_terminada(estado, dia, dias_simulacion, reglas, fin)) return fin;
+    }
+}
+
+//Distribución inclinada de los niveles de éxito para el muestreo por importancia
+//log_razon[nivel] = log(p / q): se suma por cada sorteo y da el peso de la corrida
+struct InclinacionNiveles {
+    double q[NIVELES_EXITO];
+    double log_razon[NIVELES_EXITO];
+};
+
+//Colapso: los equipos fracasan con probabilidad inclinacion. Rescate: logran éxito total con probabilidad
+//inclinacion (inclinar solo a los de señales no basta: el rescate también exige no colapsar antes).
+//Los demás niveles conservan su proporción
+InclinacionNiveles inclinar_niveles(FinSimulacion objetivo, double inclinacion) {
+    InclinacionNiveles r;
+    int favorecido = objetivo == FIN_COLAPSO_MORAL ? 2 : 0;
+    double resto = 1 - PROB_NIVEL[favorecido];
+    int k; fo(k, NIVELES_EXITO) {
+        r.q[k] = k == favorecido ? inclinacion : PROB_NIVEL[k] * (1 - inclinacion) / resto;
+        r.log_razon[k] = log(PROB_NIVEL[k] / r.q[k]);
+    }
+    return r;
+}
+
+//Corrida con niveles de éxito sorteados de la distribución inclinada; dentro de cada nivel los sorteos
+//son los de generar_resultado() y calcular_unidades(), así la razón de verosimilitud solo depende del nivel
+//log_peso [out] Logaritmo del peso de la corrida (producto de p / q de todos sus sorteos de nivel)
+FinSimulacion simular_corrida_importancia(int dias_simulacion, uint64_t semilla, uint64_t corrida,
+                                          const InclinacionNiveles& inclinacion, double& log_peso) {
+    const ReglasSupervivencia& reglas = campamento.reglas;
+    int num_equipos = (int) campamento.equipos.size();
+    EstadoSupervivencia estado = {reglas.moral_inicial, 0};
+    FinSimulacion fin = FIN_LIMITE_TIEMPO;
+    log_peso = 0;
+    for (int dia = 1; ; ++dia) {
+        Recursos recursos_dia = {{0, 0, 0, 0}};
+        for (int e = 0; e < num_equipos; ++e) {
+            GeneradorContador gen_resultado(semilla, corrida, dia, e, FLUJO_RESULTADO);
+            GeneradorContador gen_unidades(semilla, corrida, dia, e, FLUJO_UNIDADES);
+            double u = (gen_resultado.siguiente() >> 11) * 0x1.0p-53;  // Uniforme en [0, 1)
+            const double* q = inclinacion.q;
+            int nivel = u < q[0] ? 0 : u < q[0] + q[1] ? 1 : 2;
+            int porcentaje = nivel == 0 ? 100 : nivel == 1 ? gen_resultado.uniforme(50, 80) : gen_resultado.uniforme(5, 29);
+            log_peso += inclinacion.log_razon[nivel];
+            recursos_dia.cantidad[campamento.equipos[e].recurso] +=
+                calcular_unidades(gen_unidades, porcentaje, campamento.equipos[e]);
+        }
+        aplicar_dia(estado, recursos_dia, reglas);
+        if (simulacion_terminada(estado, dia, dias_simulacion, reglas, fin)) return fin;
+    }
+}
+
+//Sumas de las muestras de un estimador (una por muestra: par antitético, corrida pesada o par CRN)
+struct AcumuladorEstimador {
+    long long muestras;
+    double suma[3], suma_cuadrados[3];  //Valor del estimador por término
+    double suma_base[3], suma_variante[3];  //CRN: indicadores de cada configuración
+    double suma_pesos, suma_pesos_cuadrados;  //Importancia: para el tamaño efectivo de muestra
+
+    void agregar(const AcumuladorEstimador& otro) {
+        muestras += otro.muestras;
+        int k; fo(k, 3) {
+            suma[k] += otro.suma[k];
+            suma_cuadrados[k] += otro.suma_cuadrados[k];
+            suma_base[k] += otro.suma_base[k];
+            suma_variante[k] += otro.suma_variante[k];
+        }
+        suma_pesos += otro.suma_pesos;
+        suma_pesos_cuadrados += otro.suma_pesos_cuadrados;
+    }
+};
+
+//Modo de estimación con varianza reducida (--estimator E con --runs N)
+void modo_estimadores(const OpcionesSimulacion& opciones) {
+    const char* nombres_fin[3] = {"Rescate exitoso", "Colapso de moral", "Límite de tiempo"};
+    const string& estimador = opciones.estimador;
+    int hilos = opciones.hilos > 0 ? opciones.hilos : (int) max(1u, thread::hardware_concurrency());
+    int dias = opciones.dias_simulacion;
+    uint64_t semilla = opciones.semilla;
+
+    // Variante para CRN: la configuración vigente con el archivo --variant aplicado encima
+    ConfiguracionCampamento variante = campamento;
+    if (estimador == "crn") {
+        string error;
+        if (!cargar_configuracion(opciones.archivo_variante, variante, error)) {
+            cout << "Error en la variante: " << error << endl;
+            exit(1);
+        }
+        bool mismos_equipos = variante.equipos.size() == campamento.equipos.size();
+        for (size_t e = 0; mismos_equipos && e < variante.equipos.size(); ++e) {
+            const TipoEquipo &a = variante.equipos[e], &b = campamento.equipos[e];
+            mismos_equipos = a.recurso == b.recurso && a.base_min == b.base_min && a.base_max == b.base_max;
+        }
+        if (!mismos_equipos) {
+            cout << "Error en la variante: solo puede cambiar reglas (recurso, moral_inicial, dias_rescate)" << endl;
+            exit(1);
+        }
+    }
+    InclinacionNiveles inclinacion;
+    if (estimador == "importancia") inclinacion = inclinar_niveles(opciones.objetivo_importancia, opciones.inclinacion);
+
+    // Muestras: un par de corridas en antitetico y crn, una corrida en simple e importancia
+    int corridas_por_muestra = estimador == "antitetico" || estimador == "crn" ? 2 : 1;
+    long long muestras = max(opciones.corridas / corridas_por_muestra, 2LL);
+    vector<AcumuladorEstimador> parciales(hilos);
+    memset(parciales.data(), 0, parciales.size() * sizeof(AcumuladorEstimador));
+
+    long long t_inicio = ahora_ns();
+    repartir_bloques(opciones, hilos, muestras, 256, [&](int h, long long desde, long long hasta) {
+        AcumuladorEstimador& a = parciales[h];
+        for (long long c = desde; c < hasta; ++c) {
+            double valor[3] = {0, 0, 0};
+            if (estimador == "antitetico") {
+                valor[simular_corrida_reglas(dias, semilla, (uint64_t) c, campamento.reglas, false)] += 0.5;
+                valor[simular_corrida_reglas(dias, semilla, (uint64_t) c, campamento.reglas, true)] += 0.5;
+            } else if (estimador == "importancia") {
+                double log_peso;
+                FinSimulacion fin = simular_corrida_importancia(dias, semilla, (uint64_t) c, inclinacion, log_peso);
+                double peso = exp(log_peso);
+                valor[fin] = peso;
+                a.suma_pesos += peso;
+                a.suma_pesos_cuadrados += peso * peso;
+            } else if (estimador == "crn") {
+                FinSimulacion base = simular_corrida_reglas(dias, semilla, (uint64_t) c, campamento.reglas, false);
+                FinSimulacion otra = simular_corrida_reglas(dias, semilla, (uint64_t) c, variante.reglas, false);
+                valor[otra] += 1;
+                valor[base] -= 1;
+                a.suma_base[base] += 1;
+                a.suma_variante[otra] += 1;
+            } else {
+                valor[simular_corrida_reglas(dias, semilla, (uint64_t) c, campamento.reglas, false)] = 1;
+            }
+            int k; fo(k, 3) {
+                a.suma[k] += valor[k];
+                a.suma_cuadrados[k] += valor[k] * valor[k];
+            }
+            ++a.muestras;
+        }
+    });
+    double segundos = (ahora_ns() - t_inicio) / 1e9;
+    AcumuladorEstimador total = parciales[0];
+    for (int h = 1; h < hilos; ++h) total.agregar(parciales[h]);
+
+    // Referencia exacta (cadena de Markov); en CRN, la diferencia exacta entre variante y base
+    ResultadoExacto exacto = resolver_exacto(dias), exacto_variante = exacto;
+    if (estimador == "crn") {
+        ReglasSupervivencia reglas_base = campamento.reglas;
+        campamento.reglas = variante.reglas;
+        exacto_variante = resolver_exacto(dias);
+        campamento.reglas = reglas_base;
+    }
+
+    cout << "=== ESTIMADORES DE VARIANZA REDUCIDA ===" << endl;
+    cout << "Estimador: " << estimador;
+    if (estimador == "importancia") {
+        cout << " (objetivo " << (opciones.objetivo_importancia == FIN_RESCATE ? "rescate" : "colapso")
+             << ", nivel favorecido con probabilidad " << opciones.inclinacion << ")";
+    }
+    if (estimador == "crn") cout << " (variante " << opciones.archivo_variante << ")";
+    cout << endl;
+    cout << "Corridas: " << total.muestras * corridas_por_muestra << " (" << total.muestras << " muestras), hilos: "
+         << hilos << ", días máximos: " << dias << ", semilla: " << semilla << endl;
+    cout << "Tiempo: " << segundos << " s" << endl << endl;
+
+    double m = (double) total.muestras;
+    int k; fo(k, 3) {
+        double media = total.suma[k] / m;
+        double varianza = max((total.suma_cuadrados[k] / m - media * media) * m / (m - 1), 0.0);
+        double ic = 1.96 * sqrt(varianza / m);
+        // Varianza por muestra del muestreo simple con las mismas corridas (CRN: dos configuraciones independientes)
+        double varianza_simple;
+        double referencia;
+        if (estimador == "crn") {
+            double pb = total.suma_base[k] / m, pv = total.suma_variante[k] / m;
+            varianza_simple = pb * (1 - pb) + pv * (1 - pv);
+            referencia = exacto_variante.fines[k] - exacto.fines[k];
+            cout << "[i] " << nombres_fin[k] << ": base " << 100 * pb << "%, variante " << 100 * pv
+                 << "%, diferencia " << 100 * media << "% ± " << 100 * ic << "% (exacta " << 100 * referencia << "%)";
+        } else {
+            varianza_simple = media * (1 - media) / corridas_por_muestra;
+            referencia = exacto.fines[k];
+            cout << "[i] " << nombres_fin[k] << ": " << 100 * media << "% ± " << 100 * ic
+                 << "% (exacta " << 100 * referencia << "%)";
+        }
+        if (varianza > 0 && varianza_simple > 0) {
+            double factor = varianza_simple / varianza;
+            cout << ", reducción de varianza " << factor << "x (equivale a "
+                 << (long long) (factor * m * corridas_por_muestra) << " corridas simples)";
+        }
+        cout << endl;
+    }
+    if (estimador == "importancia") {
+        double ess = total.suma_pesos * total.suma_pesos / max(total.suma_pesos_cuadrados, 1e-300);
+        cout << "\nTamaño efectivo de muestra: " << (long long) ess << " de " << total.muestras
+             << " (peso medio " << total.suma_pesos / m << ", debe ser cercano a 1)" << endl;
+    }
+}
+
+//Barrido de Parámetros (--sweep)
+//Explora combinaciones de reglas (mínimos, penalizaciones, moral_inicial, dias_rescate) buscando las que
+//dejan la tasa de rescate dentro de una banda objetivo (--target LO:HI, en %), sin recompilar.
+//Cada candidato se evalúa con una prueba secuencial: las corridas se duplican por etapas (1024, 2048, ...
+//hasta --runs) y en cada etapa se calcula un intervalo de Wilson con nivel corregido por Bonferroni
+//sobre todas las etapas. El candidato se detiene en cuanto el intervalo queda dentro de la banda o
+//fuera de ella; si llega a --runs sin decidir, queda indeciso.
+//Todos los candidatos usan las mismas corridas (misma semilla y número de corrida): números aleatorios
+//comunes, así las diferencias entre candidatos vienen de las reglas y no del azar.
+//Con --search, en lugar de la grilla completa, se hace una búsqueda local desde el centro de la grilla
+
+const long long CORRIDAS_PRIMERA_ETAPA = 1024;   //Corridas de la primera etapa de la prueba secuencial
+const long long CORRIDAS_BARRIDO = 100000;        //Máximo de corridas por candidato sin --runs
+const long long BLOQUE_BARRIDO = 256;             //Corridas por unidad de trabajo de los hilos
+const long long MAX_CANDIDATOS_BARRIDO = 100000;  //Máximo de combinaciones de la grilla
+const double ALFA_BARRIDO = 0.05;                 //Probabilidad total de decidir mal un candidato
+
+//Parámetro barrido: nombre aceptado por fijar_parametro() y rango desde:hasta[:paso]
+struct ParametroBarrido {
+    string nombre;
+    int desde, hasta, paso;
+};
+
+enum DecisionCandidato {
+    CANDIDATO_PENDIENTE,
+    CANDIDATO_DENTRO,    //Intervalo completamente dentro de la banda objetivo
+    CANDIDATO_FUERA,     //Intervalo completamente fuera de la banda objetivo
+    CANDIDATO_INDECISO   //Se agotaron las corridas sin decidir
+};
+
+//Combinación de valores con sus reglas y el estado de su prueba secuencial
+struct CandidatoBarrido {
+    vector<int> valores;        //Un valor por ParametroBarrido
+    ReglasSupervivencia reglas;
+    long long corridas;         //Corridas ya simuladas
+    long long rescates;
+    double inferior, superior;  //Último intervalo de Wilson de la tasa de rescate
+    DecisionCandidato decision;
+
+    double tasa() const { return corridas > 0 ? (double) rescates / corridas : 0; }
+};
+
+//Lee la especificación de --sweep: nombre=desde:hasta[:paso][,nombre=...]
+//Retorna false y deja un mensaje en error si está mal formada o algún parámetro no existe
+bool leer_barrido(const string& espec, vector<ParametroBarrido>& parametros, string& error) {
+    stringstream flujo(espec);
+    string item;
+    while (getline(flujo, item, ',')) {
+        size_t igual = item.find('=');
+        ParametroBarrido p = {item.substr(0, igual), 0, 0, 1};
+        int campos = igual == string::npos ? 0 : sscanf(item.c_str() + igual + 1, "%d:%d:%d", &p.desde, &p.hasta, &p.paso);
+        if (campos < 2 || p.paso <= 0 || p.hasta < p.desde) {
+            error = "'" + item + "' debe ser nombre=desde:hasta[:paso] con desde <= hasta y paso > 0";
+            return false;
+        }
+        ReglasSupervivencia prueba = campamento.reglas;
+        if (!fijar_parametro(campamento, prueba, p.nombre, p.desde, error) ||
+            !fijar_parametro(campamento, prueba, p.nombre, p.hasta, error)) return false;
+        parametros.push_back(p);
+    }
+    if (parametros.empty()) {
+        error = "no hay parámetros que barrer";
+        return false;
+    }
+    return true;
+}
+
+//Crea un candidato con las reglas vigentes y los valores dados para los parámetros barridos
+CandidatoBarrido crear_candidato(const vector<ParametroBarrido>& parametros, const vector<int>& valores) {
+    CandidatoBarrido c = {valores, campamento.reglas, 0, 0, 0, 1, CANDIDATO_PENDIENTE};
+    string error;
+    for (size_t i = 0; i < parametros.size(); ++i) fijar_parametro(campamento, c.reglas, parametros[i].nombre, valores[i], error);
+    return c;
+}
+
+//z tal que P(Z > z) = cola para la normal estándar (bisección sobre erfc)
+double cuantil_normal(double cola) {
+    double bajo = 0, alto = 40;
+    int i; fo(i, 100) {
+        double medio = (bajo + alto) / 2;
+        if (0.5 * erfc(medio / sqrt(2.0)) > cola) bajo = medio;
+        else alto = medio;
+    }
+    return (bajo + alto) / 2;
+}
+
+//Evalúa en paralelo los candidatos pendientes con la prueba secuencial por etapas
+//En cada etapa, las corridas de todos los candidatos aún pendientes se reparten entre los hilos en bloques
+void evaluar_candidatos(const OpcionesSimulacion& opciones, int hilos, long long max_corridas,
+                        vector<CandidatoBarrido*> candidatos, double banda_min, double banda_max) {
+    int etapas = 1;
+    for (long long n = CORRIDAS_PRIMERA_ETAPA; n < max_corridas; n *= 2) ++etapas;
+    double z = cuantil_normal(ALFA_BARRIDO / (2 * etapas));
+
+    for (long long meta = min(CORRIDAS_PRIMERA_ETAPA, max_corridas); !candidatos.empty();
+         meta = min(meta * 2, max_corridas)) {
+        // Bloques de cada candidato en esta etapa; inicio_bloques[i] es el primer bloque del candidato i
+        vector<long long> inicio_bloques = {0};
+        for (CandidatoBarrido* c : candidatos) {
+            inicio_bloques.push_back(inicio_bloques.back() + (meta - c->corridas + BLOQUE_BARRIDO - 1) / BLOQUE_BARRIDO);
+        }
+        vector<atomic<long long>> rescates(candidatos.size());
+        repartir_bloques(opciones, hilos, inicio_bloques.back(), 1, [&](int, long long desde, long long hasta) {
+            for (long long b = desde; b < hasta; ++b) {
+                size_t i = upper_bound(inicio_bloques.begin(), inicio_bloques.end(), b) - inicio_bloques.begin() - 1;
+                const CandidatoBarrido& c = *candidatos[i];
+                long long primera = c.corridas + (b - inicio_bloques[i]) * BLOQUE_BARRIDO;
+                long long ultima = min(primera + BLOQUE_BARRIDO, meta);
+                long long r = 0;
+                for (long long corrida = primera; corrida < ultima; ++corrida) {
+                    r += simular_corrida_reglas(opciones.dias_simulacion, opciones.semilla, (uint64_t) corrida,
+                                                c.reglas, false) == FIN_RESCATE;
+                }
+                rescates[i].fetch_add(r, memory_order_relaxed);
+            }
+        });
+
+        // Intervalo de Wilson de cada candidato y decisión
+        vector<CandidatoBarrido*> pendientes;
+        for (size_t i = 0; i < candidatos.size(); ++i) {
+            CandidatoBarrido& c = *candidatos[i];
+            c.rescates += rescates[i].load();
+            c.corridas = meta;
+            double n = (double) meta, p = c.tasa(), z2 = z * z;
+            double centro = (p + z2 / (2 * n)) / (1 + z2 / n);
+            double margen = z * sqrt(p * (1 - p) / n + z2 / (4 * n * n)) / (1 + z2 / n);
+            c.inferior = centro - margen;
+            c.superior = centro + margen;
+            if (c.inferior >= banda_min && c.superior <= banda_max) c.decision = CANDIDATO_DENTRO;
+            else if (c.superior < banda_min || c.inferior > banda_max) c.decision = CANDIDATO_FUERA;
+            else if (meta >= max_corridas) c.decision = CANDIDATO_INDECISO;
+            else pendientes.push_back(&c);
+        }
+        candidatos = pendientes;
+    }
+}
+
+//Muestra una fila de la tabla de candidatos
+void mostrar_candidato(const vector<ParametroBarrido>& parametros, const CandidatoBarrido& c) {
+    const char* decisiones[] = {"pendiente", "DENTRO", "fuera", "indeciso"};
+    string valores;
+    for (size_t i = 0; i < parametros.size(); ++i) {
+        valores += (i > 0 ? " " : "") + parametros[i].nombre + "=" + to_string(c.valores[i]);
+    }
+    cout << "  " << valores << ": rescate " << 100 * c.tasa() << "% [" << 100 * c.inferior << "%, "
+         << 100 * c.superior << "%] en " << c.corridas << " corridas -> " << decisiones[c.decision] << endl;
+}
+
+//Modo de barrido (--sweep ESPEC --target LO:HI [--search] [--runs N])
+void modo_barrido(const OpcionesSimulacion& opciones) {
+    vector<ParametroBarrido> parametros;
+    string error;
+    if (!leer_barrido(opciones.barrido, parametros, error)) {
+        cout << "Error en --sweep: " << error << endl;
+        exit(1);
+    }
+    int hilos = opciones.hilos > 0 ? opciones.hilos : (int) max(1u, thread::hardware_concurrency());
+    long long max_corridas = opciones.corridas > 0 ? opciones.corridas : CORRIDAS_BARRIDO;
+    double banda_min = opciones.banda_min / 100, banda_max = opciones.banda_max / 100;
+    long long tamano_grilla = 1;
+    for (const ParametroBarrido& p : parametros) {
+        tamano_grilla *= (p.hasta - p.desde) / p.paso + 1;
+        if (tamano_grilla > MAX_CANDIDATOS_BARRIDO) {
+            cout << "Error en --sweep: la grilla supera " << MAX_CANDIDATOS_BARRIDO << " combinaciones" << endl;
+            exit(1);
+        }
+    }
+
+    cout << "=== BARRIDO DE PARÁMETROS ===" << endl;
+    cout << "Objetivo: tasa de rescate entre " << opciones.banda_min << "% y " << opciones.banda_max << "%" << endl;
+    cout << "Grilla: " << tamano_grilla << " combinaciones, hasta " << max_corridas << " corridas por candidato, hilos: "
+         << hilos << ", días máximos: " << opciones.dias_simulacion << ", semilla: " << opciones.semilla << endl;
+    cout << "Modo: " << (opciones.busqueda ? "búsqueda local desde el centro de la grilla" : "grilla completa") << endl << endl;
+
+    long long t_inicio = ahora_ns();
+    // Candidatos evaluados, por valores (la búsqueda local no repite puntos ya visitados)
+    map<vector<int>, CandidatoBarrido> evaluados;
+    if (!opciones.busqueda) {
+        vector<CandidatoBarrido*> grilla;
+        vector<int> valores;
+        for (const ParametroBarrido& p : parametros) valores.push_back(p.desde);
+        for (long long g = 0; g < tamano_grilla; ++g) {
+            grilla.push_back(&(evaluados[valores] = crear_candidato(parametros, valores)));
+            // Siguiente combinación (odómetro: el último parámetro varía más rápido)
+            for (int i = (int) parametros.size() - 1; i >= 0; --i) {
+                valores[i] += parametros[i].paso;
+                if (valores[i] <= parametros[i].hasta) break;
+                valores[i] = parametros[i].desde;
+            }
+        }
+        evaluar_candidatos(opciones, hilos, max_corridas, grilla, banda_min, banda_max);
+        for (CandidatoBarrido* c : grilla) mostrar_candidato(parametros, *c);
+    } else {
+        // Búsqueda local: se mueve al vecino (un paso en un parámetro) con la tasa más cercana al centro de
+        // la banda; termina cuando el actual queda DENTRO o ningún vecino mejora
+        double centro_banda = (banda_min + banda_max) / 2;
+        vector<int> actual;
+        for (const ParametroBarrido& p : parametros) actual.push_back(p.desde + (p.hasta - p.desde) / p.paso / 2 * p.paso);
+        evaluados[actual] = crear_candidato(parametros, actual);
+        evaluar_candidatos(opciones, hilos, max_corridas, {&evaluados[actual]}, banda_min, banda_max);
+        for (int paso = 1; ; ++paso) {
+            CandidatoBarrido& c = evaluados[actual];
+            cout << "Paso " << paso << ":" << endl;
+            mostrar_candidato(parametros, c);
+            if (c.decision == CANDIDATO_DENTRO) break;
+
+            vector<vector<int>> vecinos;
+            vector<CandidatoBarrido*> nuevos;
+            for (size_t i = 0; i < parametros.size(); ++i) {
+                for (int signo : {-1, 1}) {
+                    vector<int> v = actual;
+                    v[i] += signo * parametros[i].paso;
+                    if (v[i] < parametros[i].desde || v[i] > parametros[i].hasta) continue;
+                    vecinos.push_back(v);
+                    if (evaluados.count(v)) continue;
+                    nuevos.push_back(&(evaluados[v] = crear_candidato(parametros, v)));
+                }
+            }
+            evaluar_candidatos(opciones, hilos, max_corridas, nuevos, banda_min, banda_max);
+            vector<int> mejor = actual;
+            double distancia_mejor = fabs(c.tasa() - centro_banda);
+            for (const vector<int>& v : vecinos) {
+                double distancia = fabs(evaluados[v].tasa() - centro_banda);
+                if (distancia < distancia_mejor) {
+                    distancia_mejor = distancia;
+                    mejor = v;
+                }
+            }
+            if (mejor == actual) {
+                cout << "Ningún vecino se acerca más a la banda objetivo" << endl;
+                break;
+            }
+            actual = mejor;
+        }
+    }
+    double segundos = (ahora_ns() - t_inicio) / 1e9;
+
+    long long corridas_totales = 0, dentro = 0;
+    for (const auto& [valores, c] : evaluados) {
+        corridas_totales += c.corridas;
+        dentro += c.decision == CANDIDATO_DENTRO;
+    }
+    cout << endl << "Candidatos evaluados: " << evaluados.size() << ", dentro de la banda: " << dentro << endl;
+    cout << "Corridas: " << corridas_totales << " de " << (long long) evaluados.size() * max_corridas
+         << " sin detención temprana (" << 100.0 * corridas_totales / ((double) evaluados.size() * max_corridas) << "%)" << endl;
+    cout << "Tiempo: " << segundos << " s" << endl;
+    if (dentro > 0) {
+        cout << "Candidatos dentro de la banda:" << endl;
+        for (const auto& [valores, c] : evaluados) {
+            if (c.decision == CANDIDATO_DENTRO) mostrar_candidato(parametros, c);
+        }
+    }
+}
+
+//Modo de Flujo Continuo (--stream DÍAS)
+//Simula DÍAS días (millones o más) encadenando escenarios: cuando un escenario termina por rescate o
+//colapso, el siguiente parte con moral_inicial y racha 0. No guarda nada por día: solo agregados en línea
+//(media y varianza de Welford por equipo, cuantiles P² de unidades por recurso, de la moral y de la
+//duración de los escenarios), así la memoria es O(equipos) sin importar cuántos días se simulen.
+//El escenario s usa la corrida s del generador, por lo que el flujo es reproducible con --seed.
+//Con --snapshot F se agrega a F una línea JSON con los agregados cada --snapshot-every K días
+//Con --checkpoint F el estado completo (EstadoFlujo y los agregados por equipo) se guarda cada
+//--checkpoint-every K días y --resume lo retoma: los agregados y las instantáneas quedan iguales a los de
+//una ejecución sin interrupciones
+
+const long long DIAS_ENTRE_INSTANTANEAS = 100000;  //Días entre instantáneas sin --snapshot-every
+
+//Media y varianza en línea (algoritmo de Welford): una pasada, estable numéricamente
+struct EstadisticaEnLinea {
+    long long n = 0;
+    double media = 0, m2 = 0;
+
+    void agregar(double x) {
+        ++n;
+        double delta = x - media;
+        media += delta / n;
+        m2 += delta * (x - media);
+    }
+    double desviacion() const { return n > 1 ? sqrt(m2 / (n - 1)) : 0; }
+};
+
+//Estimador de un cuantil en línea con 5 marcadores (algoritmo P² de Jain y Chlamtac): memoria constante
+struct CuantilP2 {
+    double p;                //Cuantil buscado (0..1)
+    long long n = 0;         //Muestras vistas
+    double altura[5];        //Alturas de los marcadores (altura[2] estima el cuantil)
+    double posicion[5];      //Posiciones reales de los marcadores
+    double deseada[5];       //Posiciones deseadas
+    double incremento[5];    //Avance de las posiciones deseadas por muestra
+
+    explicit CuantilP2(double cuantil) : p(cuantil) {
+        double d[5] = {0, p / 2, p, (1 + p) / 2, 1};
+        int i; fo(i, 5) {
+            posicion[i] = i;
+            deseada[i] = 4 * d[i];
+            incremento[i] = d[i];
+        }
+    }
+
+    void agregar(double x) {
+        if (n < 5) {
+            // Las primeras 5 muestras se guardan ordenadas como alturas iniciales
+            altura[n++] = x;
+            sort(altura, altura + n);
+            return;
+        }
+        ++n;
+        int k;
+        if (x < altura[0]) { altura[0] = x; k = 0; }
+        else if (x >= altura[4]) { altura[4] = max(altura[4], x); k = 3; }
+        else for (k = 0; x >= altura[k + 1]; ++k) {}
+        int i; Fo(i, k + 1, 5) posicion[i] += 1;
+        fo(i, 5) deseada[i] += incremento[i];
+
+        // Ajustar los marcadores intermedios hacia su posición deseada (parábola, o lineal si no es monótona)
+        Fo(i, 1, 4) {
+            double d = deseada[i] - posicion[i];
+            if ((d >= 1 && posicion[i + 1] - posicion[i] > 1) || (d <= -1 && posicion[i - 1] - posicion[i] < -1)) {
+                int s = d > 0 ? 1 : -1;
+                double parabola = altura[i] + s / (posicion[i + 1] - posicion[i - 1]) *
+                    ((posicion[i] - posicion[i - 1] + s) * (altura[i + 1] - altura[i]) / (posicion[i + 1] - posicion[i]) +
+                     (posicion[i + 1] - posicion[i] - s) * (altura[i] - altura[i - 1]) / (posicion[i] - posicion[i - 1]));
+                if (altura[i - 1] < parabola && parabola < altura[i + 1]) altura[i] = parabola;
+                else altura[i] += s * (altura[i + s] - altura[i]) / (posicion[i + s] - posicion[i]);
+                posicion[i] += s;
+            }
+        }
+    }
+
+    //Estimación actual (con menos de 5 muestras, el cuantil de las muestras vistas)
+    double valor() const {
+        if (n == 0) return 0;
+        if (n < 5) return altura[min((long long) (p * n), n - 1)];
+        return altura[2];
+    }
+};
+
+//Agregados en línea de una magnitud: media, desviación y cuantiles p50, p90 y p99
+struct AgregadoFlujo {
+    EstadisticaEnLinea estadistica;
+    CuantilP2 p50{0.5}, p90{0.9}, p99{0.99};
+
+    void agregar(double x) {
+        estadistica.agregar(x);
+        p50.agregar(x);
+        p90.agregar(x);
+        p99.agregar(x);
+    }
+};
+
+//Estado del modo de flujo salvo los agregados por equipo; se copia tal cual al punto de control
+//El generador no tiene estado propio: su posición es (escenarios, dia_escenario)
+struct EstadoFlujo {
+    long long dia = 0;                  //Días simulados en total
+    long long escenarios = 0;           //Escenarios terminados (el en curso usa la corrida escenarios)
+    long long fines[2] = {0, 0};        //Escenarios terminados por rescate y por colapso
+    EstadoSupervivencia estado;         //Moral y racha del escenario en curso
+    int dia_escenario = 0;              //Días ya simulados del escenario en curso
+    AgregadoFlujo moral;                //Moral al cierre de cada día
+    AgregadoFlujo duracion;             //Días de cada escenario terminado
+    AgregadoFlujo recursos[NUM_RECURSOS]; //Unidades totales por recurso en cada día
+    double segundos = 0;                //Tiempo de simulación de ejecuciones anteriores (--resume)
+    long long bytes_instantaneas = 0;   //Largo del archivo de instantáneas hasta este estado
+};
+
+//Escribe un agregado como objeto JSON
+void escribir_agregado(ostream& salida, const AgregadoFlujo& a) {
+    salida << "{\"media\": " << a.estadistica.media << ", \"desviacion\": " << a.estadistica.desviacion()
+           << ", \"p50\": " << a.p50.valor() << ", \"p90\": " << a.p90.valor() << ", \"p99\": " << a.p99.valor() << "}";
+}
+
+//Escribe una instantánea de los agregados como una línea JSON
+void escribir_instantanea(ostream& salida, const EstadoFlujo& estado, const vector<EstadisticaEnLinea>& equipos,
+                          double segundos) {
+    salida << "{\"dia\": " << estado.dia << ", \"segundos\": " << segundos << ", \"escenarios\": " << estado.escenarios
+           << ", \"rescates\": " << estado.fines[FIN_RESCATE] << ", \"colapsos\": " << estado.fines[FIN_COLAPSO_MORAL]
+           << ", \"moral\": ";
+    escribir_agregado(salida, estado.moral);
+    salida << ", \"duracion_escenario\": ";
+    escribir_agregado(salida, estado.duracion);
+    salida << ", \"recursos\": {";
+    int k; fo(k, NUM_RECURSOS) {
+        salida << (k > 0 ? ", " : "") << "\"" << campamento.recursos[k].clave << "\": ";
+        escribir_agregado(salida, estado.recursos[k]);
+    }
+    salida << "}, \"equipos\": [";
+    for (size_t e = 0; e < equipos.size(); ++e) {
+        salida << (e > 0 ? ", " : "") << "{\"nombre\": \"" << campamento.equipos[e].nombre << "\", \"media\": "
+               << equipos[e].media << ", \"desviacion\": " << equipos[e].desviacion() << "}";
+    }
+    salida << "]}" << endl;
+}
+
+//Muestra un agregado en una línea de la salida por consola
+void mostrar_agregado(const string& nombre, const AgregadoFlujo& a) {
+    cout << "  " << nombre << ": media " << a.estadistica.media << " (desv. " << a.estadistica.desviacion()
+         << "), p50 " << a.p50.valor() << ", p90 " << a.p90.valor() << ", p99 " << a.p99.valor() << endl;
+}
+
+//Modo de flujo continuo (--stream DÍAS [--snapshot F] [--snapshot-every K] [--checkpoint F [--resume]])
+void modo_flujo(const OpcionesSimulacion& opciones) {
+    const ReglasSupervivencia& reglas = campamento.reglas;
+    int num_equipos = (int) campamento.equipos.size();
+    EstadoFlujo flujo;
+    flujo.estado = {reglas.moral_inicial, 0};
+    vector<EstadisticaEnLinea> equipos(num_equipos);  // Unidades de cada equipo por día
+
+    // Punto de control: EstadoFlujo seguido de los agregados por equipo
+    size_t tamano_estado = sizeof(EstadoFlujo) + num_equipos * sizeof(EstadisticaEnLinea);
+    vector<char> estado_guardado(tamano_estado);
+    PuntoControl pc;
+    bool reanudado = false;
+    long long cada_punto = opciones.puntos_cada > 0 ? opciones.puntos_cada : DIAS_ENTRE_PUNTOS;
+    if (!opciones.archivo_punto_control.empty()) {
+        reanudado = abrir_punto_control(opciones, PUNTO_CONTROL_FLUJO,
+                                        firma_ejecucion(PUNTO_CONTROL_FLUJO, opciones.dias_flujo, 0),
+                                        tamano_estado, pc, estado_guardado.data());
+        if (reanudado) {
+            memcpy(&flujo, estado_guardado.data(), sizeof(EstadoFlujo));
+            memcpy(equipos.data(), estado_guardado.data() + sizeof(EstadoFlujo), num_equipos * sizeof(EstadisticaEnLinea));
+        }
+    }
+
+    // Al reanudar, las instantáneas escritas después del guardado se descartan y se vuelven a generar
+    ofstream instantaneas;
+    if (!opciones.archivo_instantaneas.empty()) {
+        if (reanudado && truncate(opciones.archivo_instantaneas.c_str(), flujo.bytes_instantaneas) == -1) {
+            perror("truncate instantáneas");
+            exit(1);
+        }
+        instantaneas.open(opciones.archivo_instantaneas, reanudado ? ios::app : ios::trunc);
+        if (!instantaneas) {
+            perror("open instantáneas");
+            exit(1);
+        }
+    }
+    long long cada = opciones.dias_entre_instantaneas > 0 ? opciones.dias_entre_instantaneas : DIAS_ENTRE_INSTANTANEAS;
+
+    cout << "=== FLUJO CONTINUO ===" << endl;
+    cout << "Días: " << opciones.dias_flujo << ", equipos: " << num_equipos << ", semilla: " << opciones.semilla << endl;
+    if (instantaneas.is_open()) cout << "Instantáneas cada " << cada << " días en " << opciones.archivo_instantaneas << endl;
+    if (pc.cabecera != nullptr) cout << "Punto de control cada " << cada_punto << " días en " << opciones.archivo_punto_control << endl;
+    if (reanudado) cout << "Reanudado en el día " << flujo.dia << " (escenario " << flujo.escenarios << ", día " << flujo.dia_escenario << ")" << endl;
+    cout << endl;
+
+    long long t_inicio = ahora_ns();
+    auto segundos_totales = [&]() { return flujo.segundos + (ahora_ns() - t_inicio) / 1e9; };
+    FinSimulacion fin;
+    while (flujo.dia < opciones.dias_flujo) {
+        ++flujo.dia;
+        ++flujo.dia_escenario;
+        Recursos recursos_dia = {{0, 0, 0, 0}};
+        for (int e = 0; e < num_equipos; ++e) {
+            int unidades = sortear_unidades(opciones.semilla, (uint64_t) flujo.escenarios, flujo.dia_escenario, e);
+            recursos_dia.cantidad[campamento.equipos[e].recurso] += unidades;
+            equipos[e].agregar(unidades);
+        }
+        int k; fo(k, NUM_RECURSOS) flujo.recursos[k].agregar(recursos_dia.cantidad[k]);
+        aplicar_dia(flujo.estado, recursos_dia, reglas);
+        flujo.moral.agregar(flujo.estado.moral);
+
+        // Sin límite de días por escenario: termina solo por rescate o colapso y encadena el siguiente
+        if (simulacion_terminada(flujo.estado, flujo.dia_escenario, INT_MAX, reglas, fin)) {
+            ++flujo.fines[fin];
+            ++flujo.escenarios;
+            flujo.duracion.agregar(flujo.dia_escenario);
+            flujo.estado = {reglas.moral_inicial, 0};
+            flujo.dia_escenario = 0;
+        }
+        if (instantaneas.is_open() && (flujo.dia % cada == 0 || flujo.dia == opciones.dias_flujo)) {
+            escribir_instantanea(instantaneas, flujo, equipos, segundos_totales());
+        }
+        if (pc.cabecera != nullptr && (flujo.dia % cada_punto == 0 || flujo.dia == opciones.dias_flujo)) {
+            // Las instantáneas ya escritas deben estar en el archivo antes de guardar su largo
+            EstadoFlujo copia = flujo;
+            if (instantaneas.is_open()) copia.bytes_instantaneas = (long long) instantaneas.tellp();
+            copia.segundos = segundos_totales();
+            memcpy(estado_guardado.data(), &copia, sizeof(EstadoFlujo));
+            memcpy(estado_guardado.data() + sizeof(EstadoFlujo), equipos.data(), num_equipos * sizeof(EstadisticaEnLinea));
+            guardar_punto_control(pc, estado_guardado.data());
+        }
+    }
+    cerrar_punto_control(pc);
+    double segundos = segundos_totales();
+
+    cout << "Días simulados: " << flujo.dia << " en " << segundos << " s (" << (long long) (flujo.dia / max(segundos, 1e-9))
+         << " días/s)" << endl;
+    cout << "Escenarios terminados: " << flujo.escenarios << " (rescate " << flujo.fines[FIN_RESCATE] << ", colapso "
+         << flujo.fines[FIN_COLAPSO_MORAL] << ")";
+    if (flujo.dia_escenario > 0) cout << ", uno en curso desde hace " << flujo.dia_escenario << " días";
+    cout << endl;
+    if (flujo.escenarios > 0) {
+        cout << "Tasa de rescate: " << 100.0 * flujo.fines[FIN_RESCATE] / flujo.escenarios << "%" << endl;
+    }
+    cout << endl << "Agregados en línea:" << endl;
+    mostrar_agregado("Moral al cierre del día", flujo.moral);
+    mostrar_agregado("Días por escenario", flujo.duracion);
+    int k; fo(k, NUM_RECURSOS) mostrar_agregado(campamento.recursos[k].etiqueta + " por día", flujo.recursos[k]);
+    if (num_equipos <= MAX_EQUIPOS_DETALLE) {
+        cout << endl << "Unidades por equipo y día:" << endl;
+        for (int e = 0; e < num_equipos; ++e) {
+            cout << "  " << campamento.equipos[e].nombre_reporte << ": media " << equipos[e].media
+                 << " (desv. " << equipos[e].desviacion() << ")" << endl;
+        }
+    }
+    cout << endl << "Memoria de los agregados: " << tamano_estado << " bytes (independiente del número de días)" << endl;
+}
+
+//Microbenchmark del generador aleatorio
+//Compara sorteos por segundo del esquema original (random_device + mt19937 sembrado en cada llamada)
+//con el generador basado en contador usado por sortear_unidades()
+void bench_generador() {
+    const int N_LEGADO = 20000;      // El esquema original es lento: menos iteraciones
+    const int N_CONTADOR = 5000000;
+    long long suma = 0;              // Evita que el compilador descarte los sorteos
+
+    long long t0 = ahora_ns();
+    for (int k = 0; k < N_LEGADO; ++k) {
+        random_device rd;
+        unsigned int seed = rd() ^ static_cast<unsigned int>(time(nullptr)) ^ (getpid() << 8) ^ (k * 31);
+        mt19937 gen(seed);
+        uniform_int_distribution<> dis(1, 100);
+        suma += dis(gen);
+    }
+    double seg_legado = (ahora_ns() - t0) / 1e9;
+
+    t0 = ahora_ns();
+    for (int k = 0; k < N_CONTADOR; ++k) {
+        GeneradorContador gen(12345, (uint64_t) k, k % 30 + 1, k & 3, FLUJO_RESULTADO);
+        suma += gen.uniforme(1, 100);
+    }
+    double seg_contador = (ahora_ns() - t0) / 1e9;
+
+    t0 = ahora_ns();
+    for (int k = 0; k < N_CONTADOR / 4; ++k) {
+        suma += sortear_unidades(12345, (uint64_t) k, k % 30 + 1, k & 3);
+    }
+    double seg_unidades = (ahora_ns() - t0) / 1e9;
+
+    cout << "=== MICROBENCHMARK DEL GENERADOR ===" << endl;
+    cout << "random_device + mt19937 por sorteo: " << (long long) (N_LEGADO / seg_legado) << " sorteos/s" << endl;
+    cout << "GeneradorContador por sorteo:       " << (long long) (N_CONTADOR / seg_contador) << " sorteos/s" << endl;
+    cout << "sortear_unidades (resultado+unidades): " << (long long) (N_CONTADOR / 4 / seg_unidades)
+         << " llamadas/s" << endl;
+    cout << "Aceleración: " << (N_CONTADOR / seg_contador) / (N_LEGADO / seg_legado) << "x"
+         << " (control: " << suma % 10 << ")" << endl;
+}
+
+//Suite de Microbenchmarks (--bench)
+//Mide los caminos calientes del simulador y emite los resultados en JSON por stdout para comparar
+//versiones (make bench los guarda en bench.json)
+
+//Resultado de un microbenchmark
+struct MedicionBench {
+    string nombre;       //Identificador estable (clave para comparar entre versiones)
+    long long iteraciones;
+    double ns_por_op;    //Nanosegundos por operación
+};
+
+//Evita que el compilador descarte cálculos cuyo resultado no se usa
+volatile long long sumidero_bench = 0;
+
+//Ejecuta operacion(i) para i en [0, iteraciones) y retorna el costo promedio por operación
+template <typename Operacion>
+MedicionBench medir_bench(const string& nombre, long long iteraciones, Operacion operacion) {
+    long long t0 = ahora_ns();
+    for (long long i = 0; i < iteraciones; ++i) operacion(i);
+    return {nombre, iteraciones, (double) (ahora_ns() - t0) / iteraciones};
+}
+
+//Suite completa: generador, evaluación, fork+waitpid, ciclo de memoria compartida y latencia por día
+void bench_suite(const OpcionesSimulacion& opciones) {
+    const int num_equipos = (int) campamento.equipos.size();
+    vector<MedicionBench> mediciones;
+
+    mediciones.push_back(medir_bench("generar_resultado", 5000000, [&](long long i) {
+        GeneradorContador gen(12345, (uint64_t) i, (int) (i % 30) + 1, (int) (i % num_equipos), FLUJO_RESULTADO);
+        sumidero_bench = sumidero_bench + generar_resultado(gen, (int) (i % 30) + 1, (int) (i % num_equipos));
+    }));
+    mediciones.push_back(medir_bench("calcular_unidades", 5000000, [&](long long i) {
+        GeneradorContador gen(12345, (uint64_t) i, (int) (i % 30) + 1, (int) (i % num_equipos), FLUJO_UNIDADES);
+        sumidero_bench = sumidero_bench + calcular_unidades(gen, (int) (i % 100) + 1, campamento.equipos[i % num_equipos]);
+    }));
+    mediciones.push_back(medir_bench("sortear_dia", 1000000, [&](long long i) {
+        sumidero_bench = sumidero_bench + sortear_dia(12345, (uint64_t) i, (int) (i % 30) + 1).cantidad[RECURSO_AGUA];
+    }));
+
+    // Recursos precalculados: la medición cubre solo evaluar_supervivencia
+    const int NUM_MUESTRAS = 4096;
+    vector<Recursos> muestras(NUM_MUESTRAS);
+    for (int j = 0; j < NUM_MUESTRAS; ++j) muestras[j] = sortear_dia(777, (uint64_t) j, j % 30 + 1);
+    mediciones.push_back(medir_bench("evaluar_supervivencia", 20000000, [&](long long i) {
+        EvaluacionDia ev = evaluar_supervivencia(muestras[i & (NUM_MUESTRAS - 1)], campamento.reglas);
+        sumidero_bench = sumidero_bench + ev.moral_perdida + ev.razones;
+    }));
+
+    mediciones.push_back(medir_bench("fork_waitpid", 300, [&](long long) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("fork (bench)");
+            exit(1);
+        }
+        if (pid == 0) _exit(0);
+        waitpid(pid, NULL, 0);
+    }));
+
+    size_t tamano = tamano_memoria(num_equipos);
+    mediciones.push_back(medir_bench("shmget_shmat_shmdt", 3000, [&](long long) {
+        int shm_id = shmget(IPC_PRIVATE, tamano, IPC_CREAT | 0600);
+        if (shm_id == -1) {
+            perror("shmget (bench)");
+            exit(1);
+        }
+        SharedMemoryData* datos = (SharedMemoryData*) shmat(shm_id, NULL, 0);
+        if (datos == (void*) -1) {
+            perror("shmat (bench)");
+            shmctl(shm_id, IPC_RMID, NULL);
+            exit(1);
+        }
+        datos->num_equipos = num_equipos;  // Tocar la página para incluir el primer fallo de página
+        shmdt(datos);
+        shmctl(shm_id, IPC_RMID, NULL);
+    }));
+
+    // Latencia de un día completo sin pausas, en cada backend y modo de equipos
+    // Se repiten simulaciones (semillas consecutivas) hasta medir al menos DIAS_BENCH días
+    const int DIAS_BENCH = 200;
+    OpcionesSimulacion opciones_dia = opciones;
+    opciones_dia.solo_metricas = true;
+    opciones_dia.silencioso = true;
+    opciones_dia.escala_tiempo = 0;
+    opciones_dia.archivo_traza.clear();
+    const struct { const char* nombre; const char* backend; bool persistentes; } modos_dia[] = {
+        {"dia_fork", "procesos", false}, {"dia_persistente", "procesos", true},
+        {"dia_hilos", "hilos", false}, {"dia_hilos_persistentes", "hilos", true}, {"dia_pool", "pool", false}};
+    for (const auto& modo : modos_dia) {
+        opciones_dia.backend = modo.backend;
+        opciones_dia.equipos_persistentes = modo.persistentes;
+        long long dias = 0;
+        double latencia_total_us = 0;
+        for (int r = 0; dias < DIAS_BENCH; ++r) {
+            opciones_dia.semilla = opciones.semilla + r;
+            MetricasCoordinador m = coordinador(opciones_dia);
+            dias += m.dias_medidos;
+            latencia_total_us += m.latencia_dia_us * m.dias_medidos;
+        }
+        mediciones.push_back({modo.nombre, dias, latencia_total_us * 1000 / dias});
+    }
+
+    // Costo por evento del motor de corrutinas (--des) con 4096 equipos replicados
+    vector<TipoEquipo> equipos_base = campamento.equipos;
+    campamento.equipos = replicar_equipos(equipos_base, 4096);
+    opciones_dia.semilla = opciones.semilla;
+    MetricasEventos eventos = simular_eventos(opciones_dia);
+    campamento.equipos = equipos_base;
+    mediciones.push_back({"evento_corrutina", eventos.eventos, eventos.segundos * 1e9 / eventos.eventos});
+
+    // Salida JSON (una medición por objeto; claves estables para comparar entre versiones)
+    cout << "{" << endl;
+    cout << "  \"programa\": \"simulacion_supervivencia\"," << endl;
+    cout << "  \"compilador\": \"" << __VERSION__ << "\"," << endl;
+    cout << "  \"timestamp\": " << (long long) time(nullptr) << "," << endl;
+    cout << "  \"cpus\": " << thread::hardware_concurrency() << "," << endl;
+    cout << "  \"equipos\": " << num_equipos << "," << endl;
+    cout << "  \"dias\": " << opciones.dias_simulacion << "," << endl;
+    cout << "  \"resultados\": [" << endl;
+    for (size_t j = 0; j < mediciones.size(); ++j) {
+        const MedicionBench& m = mediciones[j];
+        cout << "    {\"nombre\": \"" << m.nombre << "\", \"iteraciones\": " << m.iteraciones
+             << ", \"ns_por_op\": " << m.ns_por_op << ", \"ops_por_s\": " << (long long) (1e9 / max(m.ns_por_op, 1e-9))
+             << "}" << (j + 1 < mediciones.size() ? "," : "") << endl;
+    }
+    cout << "  ]," << endl;
+    cout << "  \"control\": " << sumidero_bench % 10 << endl;
+    cout << "}" << endl;
+}
+
+//Función principal que gestiona los argumentos y inicia la simulación
+//argc Cantidad de argumentos
 //argv Array de argumentos (argv[1] = días de simulación opcional)
 //int Código de salida (0 = éxito, 1 = error)
  
 //Si no se proporcionan argumentos, solicita interactivamente los días
 //Valida que los días estén en el rango permitido (10-30)
 int main(int argc, char* argv[]) {
-    int dias_simulacion;
+    OpcionesSimulacion opciones;
+    int& dias_simulacion = opciones.dias_simulacion;
+
+    // Separar las opciones (--...) del argumento posicional de días
+    vector<string> posicionales;
+    bool semilla_fija = false;  // true si la semilla vino de --seed
+    for (int a = 1; a < argc; ++a) {
+        string arg = argv[a];
+        if (arg == "--persistent") {
+            opciones.equipos_persistentes = true;
+        } else if (arg == "--time-scale" && a + 1 < argc) {
+            opciones.escala_tiempo = atof(argv[++a]);
+            if (opciones.escala_tiempo < 0) {
+                cout << "Error: La escala de tiempo debe ser >= 0" << endl;
+                return 1;
+            }
+        } else if (arg == "--runs" && a + 1 < argc) {
+            opciones.corridas = atoll(argv[++a]);
+            if (opciones.corridas <= 0) {
+                cout << "Error: --runs debe ser mayor que 0" << endl;
+                return 1;
+            }
+        } else if (arg == "--threads" && a + 1 < argc) {
+            opciones.hilos = atoi(argv[++a]);
+        } else if (arg == "--backend" && a + 1 < argc) {
+            opciones.backend = argv[++a];
+            if (opciones.backend != "procesos" && opciones.backend != "hilos" && opciones.backend != "pool") {
+                cout << "Error: --backend debe ser procesos, hilos o pool" << endl;
+                return 1;
+            }
+        } else if (arg == "--seed" && a + 1 < argc) {
+            opciones.semilla = strtoull(argv[++a], NULL, 10);
+            semilla_fija = true;
+        } else if (arg == "--lockstep") {
+            opciones.lockstep = true;
+        } else if (arg == "--simd" && a + 1 < argc) {
+            opciones.simd = argv[++a];
+            if (opciones.simd != "auto" && opciones.simd != "avx2" && opciones.simd != "sse41" && opciones.simd != "escalar") {
+                cout << "Error: --simd debe ser auto, avx2, sse41 o escalar" << endl;
+                return 1;
+            }
+        } else if (arg == "--quiet") {
+            opciones.silencioso = true;
+        } else if (arg == "--bench-rng") {
+            opciones.bench_rng = true;
+        } else if (arg == "--stats") {
+            opciones.estadisticas = true;
+        } else if (arg == "--bench") {
+            opciones.bench = true;
+        } else if (arg == "--poll") {
+            opciones.espera_polling = true;
+        } else if (arg == "--config" && a + 1 < argc) {
+            opciones.archivo_config = argv[++a];
+        } else if (arg == "--teams" && a + 1 < argc) {
+            opciones.num_equipos = atoi(argv[++a]);
+            if (opciones.num_equipos < 1) {
+                cout << "Error: --teams debe ser mayor que 0" << endl;
+                return 1;
+            }
+        } else if (arg == "--deadline" && a + 1 < argc) {
+            opciones.plazo_ms = atoll(argv[++a]);
+            if (opciones.plazo_ms < 0) {
+                cout << "Error: --deadline debe ser 0 (sin plazo) o mayor" << endl;
+                return 1;
+            }
+        } else if (arg == "--inject-fault" && a + 1 < argc) {
+            string falla = argv[++a];
+            char modo[8] = "";
+            int campos = sscanf(falla.c_str(), "%d:%d:%7s", &opciones.falla_equipo, &opciones.falla_dia, modo);
+            opciones.falla_colgar = campos == 3 && string(modo) == "hang";
+            if (campos < 2 || (campos == 3 && !opciones.falla_colgar) || opciones.falla_equipo < 0 || opciones.falla_dia < 1) {
+                cout << "Error: --inject-fault espera EQUIPO:DÍA o EQUIPO:DÍA:hang (ej: 1:3)" << endl;
+                return 1;
+            }
+        } else if (arg == "--estimator" && a + 1 < argc) {
+            opciones.estimador = argv[++a];
+            if (opciones.estimador != "simple" && opciones.estimador != "antitetico" &&
+                opciones.estimador != "importancia" && opciones.estimador != "crn") {
+                cout << "Error: --estimator debe ser simple, antitetico, importancia o crn" << endl;
+                return 1;
+            }
+        } else if (arg == "--variant" && a + 1 < argc) {
+            opciones.archivo_variante = argv[++a];
+        } else if (arg == "--is-target" && a + 1 < argc) {
+            string objetivo = argv[++a];
+            if (objetivo != "colapso" && objetivo != "rescate") {
+                cout << "Error: --is-target debe ser colapso o rescate" << endl;
+                return 1;
+            }
+            opciones.objetivo_importancia = objetivo == "rescate" ? FIN_RESCATE : FIN_COLAPSO_MORAL;
+        } else if (arg == "--is-tilt" && a + 1 < argc) {
+            opciones.inclinacion = atof(argv[++a]);
+            if (opciones.inclinacion <= 0 || opciones.inclinacion >= 1) {
+                cout << "Error: --is-tilt debe estar entre 0 y 1 (sin incluirlos)" << endl;
+                return 1;
+            }
+        } else if (arg == "--set" && a + 1 < argc) {
+            opciones.parametros.push_back(argv[++a]);
+        } else if (arg == "--sweep" && a + 1 < argc) {
+            opciones.barrido = argv[++a];
+        } else if (arg == "--target" && a + 1 < argc) {
+            if (sscanf(argv[++a], "%lf:%lf", &opciones.banda_min, &opciones.banda_max) != 2 ||
+                opciones.banda_min < 0 || opciones.banda_max > 100 || opciones.banda_min >= opciones.banda_max) {
+                cout << "Error: --target espera LO:HI en % con 0 <= LO < HI <= 100 (ej: 40:50)" << endl;
+                return 1;
+            }
+        } else if (arg == "--search") {
+            opciones.busqueda = true;
+        } else if (arg == "--stream" && a + 1 < argc) {
+            opciones.dias_flujo = atoll(argv[++a]);
+            if (opciones.dias_flujo <= 0) {
+                cout << "Error: --stream debe ser mayor que 0" << endl;
+                return 1;
+            }
+        } else if (arg == "--snapshot" && a + 1 < argc) {
+            opciones.archivo_instantaneas = argv[++a];
+        } else if (arg == "--snapshot-every" && a + 1 < argc) {
+            opciones.dias_entre_instantaneas = atoll(argv[++a]);
+            if (opciones.dias_entre_instantaneas <= 0) {
+                cout << "Error: --snapshot-every debe ser mayor que 0" << endl;
+                return 1;
+            }
+        } else if (arg == "--checkpoint" && a + 1 < argc) {
+            opciones.archivo_punto_control = argv[++a];
+        } else if (arg == "--checkpoint-every" && a + 1 < argc) {
+            opciones.puntos_cada = atoll(argv[++a]);
+            if (opciones.puntos_cada <= 0) {
+                cout << "Error: --checkpoint-every debe ser mayor que 0" << endl;
+                return 1;
+            }
+        } else if (arg == "--resume") {
+            opciones.reanudar = true;
+        } else if (arg == "--cpus" && a + 1 < argc) {
+            string error;
+            if (!leer_lista_cpus(argv[++a], opciones.cpus, error)) {
+                cout << "Error en --cpus: " << error << endl;
+                return 1;
+            }
+        } else if (arg == "--sched" && a + 1 < argc) {
+            opciones.politica = argv[++a];
+            if (opciones.politica != "fifo" && opciones.politica != "alta") {
+                cout << "Error: --sched debe ser fifo o alta" << endl;
+                return 1;
+            }
+        } else if (arg == "--numa") {
+            opciones.numa = true;
+        } else if (arg == "--jitter") {
+            opciones.comparar_jitter = true;
+        } else if (arg == "--pipeline") {
+            opciones.pipeline = true;
+        } else if (arg == "--des") {
+            opciones.eventos_discretos = true;
+        } else if (arg == "--scaling") {
+            opciones.escalamiento = true;
+        } else if (arg == "--trace" && a + 1 < argc) {
+            opciones.archivo_traza = argv[++a];
+        } else if (arg == "--replay" && a + 1 < argc) {
+            opciones.archivo_replay = argv[++a];
+        } else if (arg == "--query" && a + 1 < argc) {
+            opciones.archivo_consulta = argv[++a];
+        } else if (arg == "--exact") {
+            opciones.exacto = true;
+        } else if (arg == "--run" && a + 1 < argc) {
+            opciones.corrida_replay = atoll(argv[++a]);
+        } else if (arg.rfind("--", 0) == 0) {
+            cout << "Error: Opción desconocida " << arg << endl;
+            return 1;
+        } else {
+            posicionales.push_back(arg);
+        }
+    }
+
+    if (opciones.reanudar && opciones.archivo_punto_control.empty()) {
+        cout << "Error: --resume requiere --checkpoint F" << endl;
+        return 1;
+    }
+    // Al reanudar sin --seed, la semilla es la de la ejecución interrumpida
+    if (opciones.reanudar && !semilla_fija && !semilla_punto_control(opciones.archivo_punto_control, opciones.semilla)) {
+        cout << "Error: no se puede reanudar: " << opciones.archivo_punto_control << " no existe o no es un punto de control" << endl;
+        return 1;
+    }
+    if (!semilla_fija && !opciones.reanudar) opciones.semilla = semilla_aleatoria();
+
+    // El motor de eventos no crea procesos ni hilos por equipo: admite muchos más equipos
+    int max_equipos = opciones.eventos_discretos ? MAX_EQUIPOS_EVENTOS : MAX_EQUIPOS;
+    if (opciones.num_equipos > max_equipos) {
+        cout << "Error: --teams debe estar entre 1 y " << max_equipos
+             << (opciones.eventos_discretos ? " con --des" : " (hasta " + to_string(MAX_EQUIPOS_EVENTOS) + " con --des)") << endl;
+        return 1;
+    }
+
+    // La configuración queda fija antes de crear procesos o hilos
+    if (!opciones.archivo_config.empty()) {
+        string error;
+        if (!cargar_configuracion(opciones.archivo_config, campamento, error)) {
+            cout << "Error en la configuración: " << error << endl;
+            return 1;
+        }
+    }
+    for (const string& parametro : opciones.parametros) {
+        size_t igual = parametro.find('=');
+        string error = "se espera NOMBRE=VALOR";
+        if (igual == string::npos ||
+            !fijar_parametro(campamento, campamento.reglas, parametro.substr(0, igual), atoi(parametro.c_str() + igual + 1), error)) {
+            cout << "Error en --set " << parametro << ": " << error << endl;
+            return 1;
+        }
+    }
+    if (opciones.num_equipos > 0) {
+        campamento.equipos = replicar_equipos(campamento.equipos, opciones.num_equipos);
+    }
+
+    // Modos sobre trazas ya grabadas: no simulan
+    if (!opciones.archivo_replay.empty()) return reproducir_traza(opciones.archivo_replay, opciones.corrida_replay);
+    if (!opciones.archivo_consulta.empty()) return consultar_traza(opciones.archivo_consulta);
+    if (!opciones.archivo_traza.empty() && opciones.lockstep) {
+        cout << "Error: --trace no es compatible con --lockstep (use el motor escalar del modo batch)" << endl;
+        return 1;
+    }
+    if (opciones.falla_dia > 0 && (opciones.backend != "procesos" || opciones.eventos_discretos)) {
+        cout << "Error: --inject-fault solo aplica al backend de procesos (un hilo no puede morir por separado)" << endl;
+        return 1;
+    }
+    if (opciones.falla_equipo >= (int) campamento.equipos.size()) {
+        cout << "Error: --inject-fault: el equipo debe estar entre 0 y " << campamento.equipos.size() - 1 << endl;
+        return 1;
+    }
+    if (!opciones.estimador.empty() && opciones.corridas <= 0) {
+        cout << "Error: --estimator requiere --runs N" << endl;
+        return 1;
+    }
+    if (opciones.estimador == "crn" && opciones.archivo_variante.empty()) {
+        cout << "Error: --estimator crn requiere --variant F (configuración a comparar)" << endl;
+        return 1;
+    }
+    if (!opciones.barrido.empty() && opciones.banda_min < 0) {
+        cout << "Error: --sweep requiere --target LO:HI (banda de la tasa de rescate en %)" << endl;
+        return 1;
+    }
+    if (!opciones.archivo_instantaneas.empty() && opciones.dias_flujo == 0) {
+        cout << "Error: --snapshot requiere --stream DÍAS" << endl;
+        return 1;
+    }
+    bool batch_simple = opciones.corridas > 0 && opciones.estimador.empty() && opciones.barrido.empty() &&
+                        !opciones.exacto && !opciones.bench && !opciones.escalamiento;
+    if (!opciones.archivo_punto_control.empty() && opciones.dias_flujo == 0 && (!batch_simple || !opciones.archivo_traza.empty())) {
+        cout << "Error: --checkpoint aplica al modo batch (--runs N, sin --trace) y al flujo continuo (--stream)" << endl;
+        return 1;
+    }
+    bool ajustes_cpu = !opciones.cpus.empty() || !opciones.politica.empty() || opciones.numa;
+    if (ajustes_cpu && (opciones.corridas > 0 || opciones.eventos_discretos || opciones.dias_flujo > 0 || opciones.exacto || opciones.bench)) {
+        cout << "Error: --cpus, --sched y --numa aplican al coordinador y sus equipos (modo normal, --scaling o --jitter)" << endl;
+        return 1;
+    }
+    if (opciones.comparar_jitter && !ajustes_cpu) {
+        cout << "Error: --jitter compara contra --cpus, --sched o --numa (indique al menos uno)" << endl;
+        return 1;
+    }
+    if (opciones.inclinacion < 0) opciones.inclinacion = opciones.objetivo_importancia == FIN_RESCATE ? 0.35 : 0.3;
+    if (!opciones.archivo_traza.empty() && opciones.eventos_discretos) {
+        cout << "Error: --trace no es compatible con --des" << endl;
+        return 1;
+    }
+
+    if (opciones.bench_rng) {
+        bench_generador();
+        return 0;
+    }
+    if (opciones.dias_flujo > 0) {
+        // El flujo continuo no usa el límite MIN_DIAS..MAX_DIAS: sus escenarios terminan por rescate o colapso
+        if (!posicionales.empty()) {
+            cout << "Error: --stream DÍAS reemplaza al argumento de días" << endl;
+            return 1;
+        }
+        modo_flujo(opciones);
+        return 0;
+    }
 
-    if (argc == 2) {
+    if (posicionales.size() == 1) {
         // Modo con argumento: ./programa <días>
-        dias_simulacion = atoi(argv[1]);
+        dias_simulacion = atoi(posicionales[0].c_str());
         if (dias_simulacion < MIN_DIAS || dias_simulacion > MAX_DIAS) {
             cout << "Error: Los días deben estar entre " << MIN_DIAS << " y " << MAX_DIAS << endl;
             return 1;
         }
-    } else if (argc == 1) {
+    } else if (posicionales.empty() && (opciones.corridas > 0 || opciones.escalamiento || opciones.exacto || opciones.bench ||
+                                        !opciones.barrido.empty() || opciones.comparar_jitter)) {
+        // Modo batch, de escalamiento, exacto, de barrido o de benchmarks sin días explícitos: usar el máximo permitido
+        dias_simulacion = MAX_DIAS;
+    } else if (posicionales.empty()) {
         // Modo interactivo: solicitar días al usuario
         cout << "=== SISTEMA DE SUPERVIVENCIA ===" << endl;
         cout << "Ingrese el número de días a simular (" << MIN_DIAS << "-" << MAX_DIAS << "): ";
@@ -539,13 +4745,59 @@ int main(int argc, char* argv[]) {
         cout << endl;
     } else {
         // Uso incorrecto: mostrar ayuda
-        cout << "Uso: " << argv[0] << " [días_simulacion]" << endl;
+        cout << "Uso: " << argv[0] << " [--backend B | --des] [--persistent] [--pipeline] [--deadline MS] [--inject-fault E:D[:hang]] [--poll] [--time-scale S] [--runs N [--threads T] [--lockstep [--simd K]]] [--seed S] [--quiet] [--stats] [--config F] [--teams N] [--scaling] [--trace F] [--replay F [--run K]] [--query F] [--exact] [--estimator E [--variant F] [--is-target T] [--is-tilt P]] [--set P=V] [--sweep ESPEC --target LO:HI [--search]] [--stream D [--snapshot F [--snapshot-every K]]] [--checkpoint F [--checkpoint-every K] [--resume]] [--cpus LISTA] [--sched fifo|alta] [--numa] [--jitter] [--bench] [--bench-rng] [días_simulacion]" << endl;
         cout << "O ejecute sin argumentos para ingreso interactivo" << endl;
+        cout << "  --backend B   Ejecución de los equipos: procesos (fork), hilos o pool (robo de trabajo, --threads T)" << endl;
+        cout << "  --des         Equipos como corrutinas en un motor de eventos discretos de un hilo (tiempo solo virtual)" << endl;
+        cout << "  --persistent  Crea los equipos una sola vez y los reutiliza cada día" << endl;
+        cout << "  --pipeline    Los equipos trabajan el día siguiente mientras el coordinador evalúa y muestra el actual" << endl;
+        cout << "  --deadline MS Plazo real por día; los equipos que no reportan se terminan y cuentan como fallidos (0: sin plazo)" << endl;
+        cout << "  --inject-fault E:D[:hang]  El equipo E muere (o se cuelga) a mitad del día D, para probar la supervisión" << endl;
+        cout << "  --poll        El coordinador sondea cada 100ms en lugar de bloquearse en eventfd/epoll" << endl;
+        cout << "  --cpus LISTA  Fija el coordinador a la primera CPU (ej: 0-3,6) y los equipos a las demás (sched_setaffinity)" << endl;
+        cout << "  --sched P     Política del coordinador y los equipos: fifo (SCHED_FIFO) o alta (nice " << NICE_ALTA << ")" << endl;
+        cout << "  --numa        Ubica la memoria de la simulación en el nodo NUMA de la CPU del coordinador" << endl;
+        cout << "  --jitter      Compara el jitter por día sin y con --cpus/--sched/--numa" << endl;
+        cout << "  --time-scale S  Segundos reales por segundo simulado (0 = instantáneo, 1 = por defecto)" << endl;
+        cout << "  --runs N      Modo batch: N simulaciones sin procesos ni salida, con tasas agregadas" << endl;
+        cout << "  --threads T   Hilos del modo batch (por defecto, todos los núcleos)" << endl;
+        cout << "  --lockstep    Modo batch con motor SoA vectorial (miles de corridas en paralelo)" << endl;
+        cout << "  --simd K      Kernel del motor lockstep: auto, avx2, sse41 o escalar" << endl;
+        cout << "  --seed S      Semilla global: ejecuciones reproducibles bit a bit" << endl;
+        cout << "  --quiet       Sin salida por día: solo el resultado final y las estadísticas" << endl;
+        cout << "  --stats       Histogramas p50/p99/máx de fork, fases, despertar, recoger y día completo" << endl;
+        cout << "  --config F    Carga equipos, mínimos y penalizaciones desde el archivo F" << endl;
+        cout << "  --set P=V     Fija un parámetro: minimo.<recurso>, penalizacion.<recurso>, moral_inicial o dias_rescate" << endl;
+        cout << "  --sweep ESPEC Barre P=desde:hasta[:paso],... buscando una tasa de rescate en --target LO:HI (%)," << endl;
+        cout << "                con detención temprana por candidato (--runs N: máximo por candidato; --search: búsqueda local)" << endl;
+        cout << "  --teams N     Simula N equipos replicando la tabla de equipos (máximo " << MAX_EQUIPOS
+             << "; " << MAX_EQUIPOS_EVENTOS << " con --des)" << endl;
+        cout << "  --scaling     Mide la latencia por día con 4, 16, 64 y 256 equipos" << endl;
+        cout << "  --trace F     Graba cada día en la traza binaria F (coordinador o modo batch)" << endl;
+        cout << "  --replay F    Reproduce la salida de consola de la corrida K (--run K, por defecto 0) de la traza F" << endl;
+        cout << "  --query F     Estadísticas agregadas de la traza F sin volver a simular" << endl;
+        cout << "  --estimator E Con --runs N: simple, antitetico, importancia (--is-target colapso|rescate, --is-tilt P)" << endl;
+        cout << "                o crn (--variant F: diferencia con la configuración F, números aleatorios comunes)" << endl;
+        cout << "  --stream D    Flujo continuo de D días (sin límite) encadenando escenarios, con agregados en línea" << endl;
+        cout << "                y memoria constante (--snapshot F: instantáneas JSON cada --snapshot-every K días)" << endl;
+        cout << "  --checkpoint F  Guarda el estado del modo batch o del flujo cada --checkpoint-every K corridas o días" << endl;
+        cout << "  --resume      Retoma desde el punto de control, con el mismo resultado que sin interrupciones" << endl;
+        cout << "  --exact       Probabilidades exactas por cadena de Markov (con --runs N, contrasta con N corridas)" << endl;
+        cout << "  --bench       Suite de microbenchmarks de los caminos calientes, en JSON" << endl;
+        cout << "  --bench-rng   Microbenchmark de sorteos por segundo del generador" << endl;
         cout << "Días deben estar entre " << MIN_DIAS << " y " << MAX_DIAS << endl;
         return 1;
     }
 
     // Iniciar simulación
-    coordinador(dias_simulacion);
+    if (opciones.bench) bench_suite(opciones);
+    else if (opciones.exacto) modo_exacto(opciones);
+    else if (opciones.escalamiento) medir_escalamiento(opciones);
+    else if (opciones.comparar_jitter) medir_jitter(opciones);
+    else if (!opciones.barrido.empty()) modo_barrido(opciones);
+    else if (opciones.corridas > 0 && !opciones.estimador.empty()) modo_estimadores(opciones);
+    else if (opciones.corridas > 0) batch_monte_carlo(opciones);
+    else if (opciones.eventos_discretos) simular_eventos(opciones);
+    else coordinador(opciones);
     return 0;
 }
\ No newline at end of file